@@ -0,0 +1,90 @@
+/**
+ * @file combining_flags_benchmark.cpp
+ * @brief Write throughput of @p CombiningAtomicFlags against a plain @p std::atomic under contention.
+ *
+ * @details
+ * Usage: <tt>combining_flags_benchmark [max_threads] [milliseconds]</tt>.
+ * Each thread repeatedly adds and removes its own flag for a fixed duration.
+ */
+
+#include "enum_flags/combining_flags.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+enum class Bit : std::uint64_t {};
+
+using RawType = EnumFlags<Bit>::RawType;
+
+//! Run a writer function on some threads for a duration and get the total number of operations.
+template <typename Func>
+std::uint64_t Run(const std::size_t thread_count, const std::chrono::milliseconds duration,
+                  Func&& func) {
+    std::atomic_bool start {false};
+    std::atomic_bool stop {false};
+    std::atomic_uint64_t total {0};
+    std::vector<std::thread> threads;
+    for (std::size_t t {0}; t != thread_count; ++t) {
+        threads.emplace_back([&, t] {
+            const auto bit {RawType {1} << (t % 64)};
+            while (!start.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+
+            std::uint64_t ops {0};
+            while (!stop.load(std::memory_order_relaxed)) {
+                func(bit);
+                ops += 2;
+            }
+
+            total += ops;
+        });
+    }
+
+    start = true;
+    std::this_thread::sleep_for(duration);
+    stop = true;
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    return total;
+}
+
+}  // namespace
+
+int main(const int argc, const char* const argv[]) {
+    const std::size_t max_threads {argc > 1 ? std::stoul(argv[1]) : 64};
+    const std::chrono::milliseconds duration {argc > 2 ? std::stoul(argv[2]) : 500};
+    const auto mops {[duration](const std::uint64_t ops) {
+        return static_cast<double>(ops) / std::chrono::duration<double>(duration).count() / 1e6;
+    }};
+
+    std::printf("%8s %16s %16s\n", "threads", "atomic (Mop/s)", "combining (Mop/s)");
+    for (std::size_t threads {1}; threads <= max_threads; threads *= 2) {
+        std::atomic<RawType> atomic {0};
+        const auto atomic_ops {Run(threads, duration, [&atomic](const RawType bit) {
+            atomic.fetch_or(bit, std::memory_order_acq_rel);
+            atomic.fetch_and(~bit, std::memory_order_acq_rel);
+        })};
+
+        CombiningAtomicFlags<Bit> combining {{}, threads};
+        const auto combining_ops {Run(threads, duration, [&combining](const RawType bit) {
+            combining.Add(bit);
+            combining.Remove(bit);
+        })};
+
+        std::printf("%8zu %16.2f %16.2f\n", threads, mops(atomic_ops), mops(combining_ops));
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,181 @@
+/**
+ * @file atomic_flags_array.h
+ * @brief Arrays of atomic @p EnumFlags with a selectable cache-line layout.
+ *
+ * @details
+ * A layout decides how many elements share a cache line:
+ *
+ * - @ref DenseLayout packs elements as tightly as possible.
+ *   It uses the least memory, but elements written by different threads may falsely share lines.
+ * - @ref PaddedLayout gives every element its own line, avoiding false sharing at a memory cost.
+ * - @ref GroupedLayout puts @p N consecutive elements on a line.
+ *   Elements owned by the same thread or shard should be consecutive.
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ */
+
+#pragma once
+
+#include "enum_flags.h"
+#include "parallel.h"
+
+#include <atomic>
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+//! Pack elements as tightly as possible.
+struct DenseLayout {
+    static constexpr std::size_t ElementsPerLine(const std::size_t words_per_line) noexcept {
+        return words_per_line;
+    }
+};
+
+//! Give every element its own cache line.
+struct PaddedLayout {
+    static constexpr std::size_t ElementsPerLine(std::size_t) noexcept {
+        return 1;
+    }
+};
+
+//! Put @p N consecutive elements on each cache line.
+template <std::size_t N>
+    requires(N > 0)
+struct GroupedLayout {
+    static constexpr std::size_t ElementsPerLine(std::size_t) noexcept {
+        return N;
+    }
+};
+
+//! An array of atomic @p EnumFlags with a cache-line layout.
+template <typename Enum, typename Layout = DenseLayout>
+class AtomicFlagsArray {
+public:
+    using Flags = EnumFlags<Enum>;
+    using RawType = Flags::RawType;
+    using Atomic = std::atomic<RawType>;
+
+    //! The number of elements sharing a cache line.
+    static constexpr std::size_t elements_per_line {
+        Layout::ElementsPerLine(cache_line_size / sizeof(Atomic))};
+
+    static_assert(elements_per_line * sizeof(Atomic) <= cache_line_size,
+                  "Too many elements for a cache line.");
+
+    //! Create an array of empty flags.
+    explicit AtomicFlagsArray(const std::size_t size) :
+        lines_((size + elements_per_line - 1) / elements_per_line), size_ {size} {}
+
+    AtomicFlagsArray(const AtomicFlagsArray&) = delete;
+
+    AtomicFlagsArray& operator=(const AtomicFlagsArray&) = delete;
+
+    //! Get the number of elements.
+    std::size_t Size() const noexcept {
+        return size_;
+    }
+
+    //! Get the number of bytes used by the elements.
+    std::size_t MemoryBytes() const noexcept {
+        return lines_.size() * sizeof(Line);
+    }
+
+    //! Get an element.
+    Atomic& operator[](const std::size_t i) noexcept {
+        return lines_[i / elements_per_line].words[i % elements_per_line];
+    }
+
+    //! Get an element.
+    const Atomic& operator[](const std::size_t i) const noexcept {
+        return lines_[i / elements_per_line].words[i % elements_per_line];
+    }
+
+    //! Load an element.
+    Flags Load(const std::size_t i,
+               const std::memory_order order = std::memory_order_seq_cst) const noexcept {
+        return (*this)[i].load(order);
+    }
+
+    //! Store an element.
+    void Store(const std::size_t i, const Flags flags,
+               const std::memory_order order = std::memory_order_seq_cst) noexcept {
+        (*this)[i].store(flags, order);
+    }
+
+    //! Add specific flags to an element and get its previous flags.
+    Flags Add(const std::size_t i, const Flags flags,
+              const std::memory_order order = std::memory_order_seq_cst) noexcept {
+        return (*this)[i].fetch_or(flags, order);
+    }
+
+    //! Remove specific flags from an element and get its previous flags.
+    Flags Remove(const std::size_t i, const Flags flags,
+                 const std::memory_order order = std::memory_order_seq_cst) noexcept {
+        return (*this)[i].fetch_and(static_cast<RawType>(~static_cast<RawType>(flags)), order);
+    }
+
+    /**
+     * @brief Add specific flags to all elements.
+     *
+     * @details
+     * Each element is updated atomically, but the array as a whole is not.
+     */
+    void AddAll(const Flags flags,
+                const std::memory_order order = std::memory_order_seq_cst) noexcept {
+        ForEachElement([flags, order](Atomic& e) noexcept { e.fetch_or(flags, order); });
+    }
+
+    //! Remove specific flags from all elements.
+    void RemoveAll(const Flags flags,
+                   const std::memory_order order = std::memory_order_seq_cst) noexcept {
+        const auto mask {static_cast<RawType>(~static_cast<RawType>(flags))};
+        ForEachElement([mask, order](Atomic& e) noexcept { e.fetch_and(mask, order); });
+    }
+
+    //! Find the first element having at least one of the specific flags set.
+    std::optional<std::size_t> FindFirstAny(
+        const Flags flags,
+        const std::memory_order order = std::memory_order_seq_cst) const noexcept {
+        return FindFirst([flags](const Flags e) noexcept { return e.HasAny(flags); }, order);
+    }
+
+    //! Find the first element having all specific flags set.
+    std::optional<std::size_t> FindFirstAll(
+        const Flags flags,
+        const std::memory_order order = std::memory_order_seq_cst) const noexcept {
+        return FindFirst([flags](const Flags e) noexcept { return e.HasAll(flags); }, order);
+    }
+
+private:
+    struct alignas(cache_line_size) Line {
+        Atomic words[elements_per_line] {};
+    };
+
+    //! Visit elements line by line, so each line is fetched once.
+    template <typename Func>
+    void ForEachElement(Func&& func) noexcept {
+        for (std::size_t line {0}, i {0}; line != lines_.size(); ++line) {
+            for (std::size_t word {0}; word != elements_per_line && i != size_; ++word, ++i) {
+                func(lines_[line].words[word]);
+            }
+        }
+    }
+
+    template <typename Pred>
+    std::optional<std::size_t> FindFirst(Pred&& pred,
+                                         const std::memory_order order) const noexcept {
+        for (std::size_t line {0}, i {0}; line != lines_.size(); ++line) {
+            for (std::size_t word {0}; word != elements_per_line && i != size_; ++word, ++i) {
+                if (pred(Flags {lines_[line].words[word].load(order)})) {
+                    return i;
+                }
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    std::vector<Line> lines_;
+    std::size_t size_;
+};
@@ -0,0 +1,415 @@
+/**
+ * @file awaitable_flags.h
+ * @brief @p EnumFlags that coroutines can wait on with @p co_await.
+ *
+ * @details
+ * A suspended coroutine is linked into a waiter list for each bit whose rise may satisfy it:
+ *
+ * - A @p WhenAny waiter is linked to every bit of its mask.
+ * - A @p WhenAll waiter is linked to one missing bit only.
+ *   When that bit rises but others are still missing, it moves to another missing bit.
+ *
+ * A mutation only walks the lists of bits that have risen,
+ * so its cost tracks the affected waiters instead of all waiters.
+ * Removing flags never resumes anything.
+ *
+ * The flags are meant for a single-threaded event loop and are not thread-safe.
+ * Resumed coroutines run inline after the mutation, or are posted to a @ref SerialExecutor.
+ * A coroutine resumed inline must not destroy another coroutine resumed by the same mutation.
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ */
+
+#pragma once
+
+#include "enum_flags.h"
+
+#include <array>
+#include <bit>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <utility>
+#include <vector>
+
+//! A single-threaded executor that resumes posted coroutines in order.
+class SerialExecutor {
+public:
+    /**
+     * @brief A lazily started coroutine without a result, owned by an executor once spawned.
+     *
+     * @details
+     * A spawned coroutine is destroyed by its executor as soon as it finishes.
+     */
+    class Task {
+    public:
+        struct promise_type {
+            //! An awaiter releasing a finished coroutine from its executor.
+            struct FinalAwaiter {
+                bool await_ready() const noexcept {
+                    return false;
+                }
+
+                void await_suspend(
+                    const std::coroutine_handle<promise_type> handle) const noexcept {
+                    if (const auto executor {handle.promise().executor}; executor != nullptr) {
+                        executor->Finish(handle);
+                    }
+                }
+
+                void await_resume() const noexcept {}
+            };
+
+            Task get_return_object() noexcept {
+                return Task {std::coroutine_handle<promise_type>::from_promise(*this)};
+            }
+
+            std::suspend_always initial_suspend() const noexcept {
+                return {};
+            }
+
+            FinalAwaiter final_suspend() const noexcept {
+                return {};
+            }
+
+            void return_void() const noexcept {}
+
+            [[noreturn]] void unhandled_exception() const noexcept {
+                std::terminate();
+            }
+
+            //! The executor owning the coroutine after it is spawned.
+            SerialExecutor* executor {nullptr};
+
+            //! The position of the coroutine in the tasks of its executor.
+            std::size_t index {0};
+        };
+
+        Task(Task&& o) noexcept : handle_ {std::exchange(o.handle_, nullptr)} {}
+
+        Task& operator=(Task&&) = delete;
+
+        ~Task() noexcept {
+            if (handle_) {
+                handle_.destroy();
+            }
+        }
+
+    private:
+        friend class SerialExecutor;
+
+        explicit Task(const std::coroutine_handle<promise_type> handle) noexcept :
+            handle_ {handle} {}
+
+        std::coroutine_handle<promise_type> handle_;
+    };
+
+    SerialExecutor() noexcept = default;
+
+    SerialExecutor(const SerialExecutor&) = delete;
+
+    SerialExecutor& operator=(const SerialExecutor&) = delete;
+
+    //! Destroy spawned coroutines that have not finished.
+    ~SerialExecutor() noexcept {
+        for (const auto task : tasks_) {
+            task.destroy();
+        }
+    }
+
+    //! Take a task and post its start.
+    void Spawn(Task task) {
+        const auto handle {task.handle_};
+        tasks_.push_back(handle);
+        task.handle_ = nullptr;
+        handle.promise().executor = this;
+        handle.promise().index = tasks_.size() - 1;
+        Post(handle);
+    }
+
+    //! Post a coroutine to be resumed.
+    void Post(const std::coroutine_handle<> handle) {
+        queue_.push_back(handle);
+    }
+
+    //! Get the number of posted coroutines.
+    std::size_t Pending() const noexcept {
+        return queue_.size();
+    }
+
+    //! Get the number of spawned coroutines that have not finished.
+    std::size_t Active() const noexcept {
+        return tasks_.size();
+    }
+
+    /**
+     * @brief Resume posted coroutines until none are left, including those posted meanwhile.
+     *
+     * @return The number of resumed coroutines.
+     */
+    std::size_t Run() {
+        std::size_t count {0};
+        for (; !queue_.empty(); ++count) {
+            const auto handle {queue_.front()};
+            queue_.pop_front();
+            handle.resume();
+        }
+
+        return count;
+    }
+
+private:
+    using TaskHandle = std::coroutine_handle<Task::promise_type>;
+
+    //! Destroy a finished coroutine, moving the last task into its position.
+    void Finish(const TaskHandle handle) noexcept {
+        const auto index {handle.promise().index};
+        tasks_[index] = tasks_.back();
+        tasks_[index].promise().index = index;
+        tasks_.pop_back();
+        handle.destroy();
+    }
+
+    std::deque<std::coroutine_handle<>> queue_;
+    std::vector<TaskHandle> tasks_;
+};
+
+//! @p EnumFlags that coroutines can wait on with @p co_await.
+template <typename Enum>
+class AwaitableFlags {
+public:
+    using Flags = EnumFlags<Enum>;
+    using RawType = Flags::RawType;
+
+    class Awaiter;
+
+    /**
+     * @brief Create flags.
+     *
+     * @param flags Initial flags.
+     * @param executor An executor to post resumed coroutines to.
+     * If it is null, they are resumed inline after each mutation.
+     */
+    explicit AwaitableFlags(const Flags flags = {},
+                            SerialExecutor* const executor = nullptr) noexcept :
+        flags_ {flags}, executor_ {executor} {}
+
+    AwaitableFlags(const AwaitableFlags&) = delete;
+
+    AwaitableFlags& operator=(const AwaitableFlags&) = delete;
+
+    //! Get the flags.
+    Flags Load() const noexcept {
+        return flags_;
+    }
+
+    //! Check whether a flag is set.
+    bool Has(const Enum flag) const noexcept {
+        return flags_.Has(flag);
+    }
+
+    //! Check whether all specific flags are set.
+    bool HasAll(const Flags flags) const noexcept {
+        return flags_.HasAll(flags);
+    }
+
+    //! Check whether at least one of the specific flags is set.
+    bool HasAny(const Flags flags) const noexcept {
+        return flags_.HasAny(flags);
+    }
+
+    //! Get the number of suspended coroutines.
+    std::size_t Waiters() const noexcept {
+        return waiters_;
+    }
+
+    //! Add specific flags, resuming coroutines whose conditions become true.
+    void Add(const Flags flags) {
+        Set(Flags {flags_}.Add(flags));
+    }
+
+    //! Remove specific flags.
+    void Remove(const Flags flags) {
+        Set(Flags {flags_}.Remove(flags));
+    }
+
+    //! Reset the flags, resuming coroutines whose conditions become true.
+    void Set(const Flags flags) {
+        // Bits that are not valid flags have no waiters.
+        const auto rising {static_cast<RawType>(static_cast<RawType>(flags)
+                                                & ~static_cast<RawType>(flags_)
+                                                & static_cast<RawType>(Flags::All()))};
+        flags_ = flags;
+        if (rising != 0) {
+            Resume(Wake(rising));
+        }
+    }
+
+    /**
+     * @brief Wait until all specific flags are set.
+     *
+     * @return An awaiter producing the flags at the time the condition became true.
+     * It is ready at once for empty flags.
+     */
+    Awaiter WhenAll(const Flags flags) noexcept {
+        return {*this, flags, true};
+    }
+
+    /**
+     * @brief Wait until at least one of the specific flags is set.
+     *
+     * @return An awaiter producing the flags at the time the condition became true.
+     * It never completes for empty flags.
+     */
+    Awaiter WhenAny(const Flags flags) noexcept {
+        return {*this, flags, false};
+    }
+
+private:
+    //! A link of an awaiter into the waiter list of a bit.
+    struct Node {
+        Node* prev {nullptr};
+        Node* next {nullptr};
+        Awaiter* waiter {nullptr};
+        std::size_t bit {0};
+    };
+
+public:
+    //! An awaiter suspending a coroutine until a condition on the flags is true.
+    class Awaiter {
+    public:
+        Awaiter(const Awaiter&) = delete;
+
+        Awaiter& operator=(const Awaiter&) = delete;
+
+        //! Unlink a coroutine destroyed while suspended.
+        ~Awaiter() noexcept {
+            Unlink();
+        }
+
+        bool await_ready() noexcept {
+            result_ = owner_.flags_;
+            return Satisfied(result_);
+        }
+
+        void await_suspend(const std::coroutine_handle<> handle) {
+            handle_ = handle;
+            if (all_) {
+                nodes_.resize(1);
+                owner_.Link(nodes_.front(), *this, LowestMissingBit());
+            } else {
+                nodes_.resize(mask_.Count());
+                auto node {nodes_.begin()};
+                mask_.ForEachBit([this, &node](const std::size_t bit) noexcept {
+                    owner_.Link(*node++, *this, bit);
+                });
+            }
+
+            linked_ = true;
+            ++owner_.waiters_;
+        }
+
+        Flags await_resume() const noexcept {
+            return result_;
+        }
+
+    private:
+        friend class AwaitableFlags;
+
+        Awaiter(AwaitableFlags& owner, const Flags mask, const bool all) noexcept :
+            owner_ {owner}, mask_ {Flags {mask}.Sanitize()}, all_ {all} {}
+
+        bool Satisfied(const Flags flags) const noexcept {
+            return all_ ? flags.HasAll(mask_) : flags.HasAny(mask_);
+        }
+
+        std::size_t LowestMissingBit() const noexcept {
+            const auto missing {static_cast<RawType>(static_cast<RawType>(mask_)
+                                                     & ~static_cast<RawType>(owner_.flags_))};
+            return static_cast<std::size_t>(std::countr_zero(missing));
+        }
+
+        void Unlink() noexcept {
+            if (linked_) {
+                for (auto& node : nodes_) {
+                    owner_.Unlink(node);
+                }
+
+                linked_ = false;
+                --owner_.waiters_;
+            }
+        }
+
+        AwaitableFlags& owner_;
+        const Flags mask_;
+        const bool all_;
+
+        //! Links into the waiter lists of bits. They must not move while linked.
+        std::vector<Node> nodes_;
+
+        bool linked_ {false};
+        std::coroutine_handle<> handle_;
+        Flags result_;
+    };
+
+private:
+    static constexpr std::size_t bit_count {FlagTraits<Enum>::bit_width};
+
+    void Link(Node& node, Awaiter& waiter, const std::size_t bit) noexcept {
+        node = {nullptr, heads_[bit], &waiter, bit};
+        if (heads_[bit] != nullptr) {
+            heads_[bit]->prev = &node;
+        }
+
+        heads_[bit] = &node;
+    }
+
+    void Unlink(Node& node) noexcept {
+        (node.prev != nullptr ? node.prev->next : heads_[node.bit]) = node.next;
+        if (node.next != nullptr) {
+            node.next->prev = node.prev;
+        }
+    }
+
+    //! Unlink the waiters satisfied by rising bits and get their coroutines in order.
+    std::vector<std::coroutine_handle<>> Wake(const RawType rising) {
+        std::vector<std::coroutine_handle<>> ready;
+        Flags {rising}.ForEachBit([this, &ready](const std::size_t bit) {
+            for (auto node {heads_[bit]}; node != nullptr;) {
+                auto& waiter {*node->waiter};
+                const auto next {node->next};
+                if (waiter.Satisfied(flags_)) {
+                    waiter.Unlink();
+                    waiter.result_ = flags_;
+                    ready.push_back(waiter.handle_);
+                } else {
+                    // A waiter for all flags moves to a bit that is still missing.
+                    Unlink(*node);
+                    Link(*node, waiter, waiter.LowestMissingBit());
+                }
+
+                node = next;
+            }
+        });
+
+        return ready;
+    }
+
+    void Resume(const std::vector<std::coroutine_handle<>>& ready) {
+        // Resuming a coroutine may destroy awaiters, so only the copied handles are used.
+        for (const auto handle : ready) {
+            if (executor_ != nullptr) {
+                executor_->Post(handle);
+            } else {
+                handle.resume();
+            }
+        }
+    }
+
+    Flags flags_;
+    SerialExecutor* executor_;
+    std::array<Node*, bit_count> heads_ {};
+    std::size_t waiters_ {0};
+};
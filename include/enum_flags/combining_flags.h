@@ -0,0 +1,158 @@
+/**
+ * @file combining_flags.h
+ * @brief Flat-combining atomic @p EnumFlags for write-heavy hot spots.
+ *
+ * @details
+ * Under heavy write contention, even a single @p fetch_or makes the cache line holding the flags
+ * bounce between cores. With flat combining, a writer publishes its request in a slot
+ * on its own cache line. One writer at a time becomes the combiner,
+ * merges all pending requests into an add mask and a remove mask,
+ * and applies them with a single atomic store.
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ */
+
+#pragma once
+
+#include "enum_flags.h"
+#include "parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+//! Atomic @p EnumFlags updated through flat combining.
+template <typename Enum>
+class CombiningAtomicFlags {
+public:
+    using Flags = EnumFlags<Enum>;
+    using RawType = Flags::RawType;
+
+    /**
+     * @brief Create flags.
+     *
+     * @param flags Initial flags.
+     * @param slot_count The number of request slots, ideally no less than the number of writers.
+     */
+    explicit CombiningAtomicFlags(const Flags flags = {},
+                                  const std::size_t slot_count = DefaultThreadCount()) :
+        flags_ {flags}, slots_(std::max<std::size_t>(slot_count, 1)) {}
+
+    CombiningAtomicFlags(const CombiningAtomicFlags&) = delete;
+
+    CombiningAtomicFlags& operator=(const CombiningAtomicFlags&) = delete;
+
+    //! Get the current flags.
+    Flags Load() const noexcept {
+        return flags_.load(std::memory_order_acquire);
+    }
+
+    //! Check whether a flag is set.
+    bool Has(const Enum flag) const noexcept {
+        return Load().Has(flag);
+    }
+
+    //! Check whether all specific flags are set.
+    bool HasAll(const Flags flags) const noexcept {
+        return Load().HasAll(flags);
+    }
+
+    //! Check whether at least one of the specific flags is set.
+    bool HasAny(const Flags flags) const noexcept {
+        return Load().HasAny(flags);
+    }
+
+    //! Add specific flags.
+    void Add(const Flags flags) noexcept {
+        Update(flags, {});
+    }
+
+    //! Remove specific flags.
+    void Remove(const Flags flags) noexcept {
+        Update({}, flags);
+    }
+
+    /**
+     * @brief Remove and add specific flags in one request.
+     *
+     * @details
+     * It returns after the request has been applied by a combiner, possibly the calling thread.
+     *
+     * @param add Flags to add.
+     * @param remove Flags to remove. Flags also in @p add are added.
+     */
+    void Update(const Flags add, const Flags remove) noexcept {
+        auto& slot {Claim()};
+        slot.add = add;
+        slot.remove = remove;
+        slot.state.store(SlotState::Pending, std::memory_order_release);
+        while (slot.state.load(std::memory_order_acquire) != SlotState::Done) {
+            if (!combining_.exchange(true, std::memory_order_acquire)) {
+                Combine();
+                combining_.store(false, std::memory_order_release);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+
+        slot.state.store(SlotState::Free, std::memory_order_release);
+    }
+
+private:
+    enum class SlotState : std::uint8_t { Free, Claimed, Pending, Merged, Done };
+
+    struct alignas(cache_line_size) Slot {
+        std::atomic<SlotState> state {SlotState::Free};
+        Flags add;
+        Flags remove;
+    };
+
+    //! Claim a free slot, starting from the one assigned to the calling thread.
+    Slot& Claim() noexcept {
+        for (auto i {ThreadIndex()};; ++i) {
+            auto& slot {slots_[i % slots_.size()]};
+            auto expected {SlotState::Free};
+            if (slot.state.compare_exchange_weak(expected, SlotState::Claimed,
+                                                 std::memory_order_acquire,
+                                                 std::memory_order_relaxed)) {
+                return slot;
+            }
+
+            if (i % slots_.size() == slots_.size() - 1) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    //! Apply all pending requests with a single store. It must be called by the combiner only.
+    void Combine() noexcept {
+        RawType add {0};
+        RawType remove {0};
+        for (auto& slot : slots_) {
+            // The owner of a pending slot does not touch it until it is done.
+            if (slot.state.load(std::memory_order_acquire) == SlotState::Pending) {
+                remove = static_cast<RawType>((remove & ~static_cast<RawType>(slot.add))
+                                              | slot.remove);
+                add = static_cast<RawType>((add & ~static_cast<RawType>(slot.remove)) | slot.add);
+                slot.state.store(SlotState::Merged, std::memory_order_relaxed);
+            }
+        }
+
+        const auto flags {flags_.load(std::memory_order_relaxed)};
+        flags_.store(static_cast<RawType>((flags & ~remove) | add), std::memory_order_release);
+
+        for (auto& slot : slots_) {
+            if (slot.state.load(std::memory_order_relaxed) == SlotState::Merged) {
+                slot.state.store(SlotState::Done, std::memory_order_release);
+            }
+        }
+    }
+
+    alignas(cache_line_size) std::atomic<RawType> flags_;
+    alignas(cache_line_size) std::atomic_bool combining_ {false};
+    std::vector<Slot> slots_;
+};
@@ -0,0 +1,305 @@
+/**
+ * @file concurrent_flag_store.h
+ * @brief A concurrent hash map from keys to atomic @p EnumFlags.
+ *
+ * @details
+ * Keys are spread over independently locked shards, each an open-addressing table of entries.
+ *
+ * - Lookups never lock. They probe a snapshot of the shard table.
+ * - Flags of an existing entry are updated with atomic read-modify-write operations.
+ * - Inserting a key locks its shard only. A full table is resized by the inserting thread,
+ *   which copies entry pointers into a larger table and publishes it.
+ *   Entries never move, so updates through an old table remain visible.
+ *   Old tables are kept until the store is destroyed, as readers may still probe them.
+ * - Bulk scans process shards in parallel without blocking writers.
+ *
+ * Entries are never erased.
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ */
+
+#pragma once
+
+#include "enum_flags.h"
+#include "parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+//! A concurrent hash map from keys to atomic @p EnumFlags.
+template <typename Key, typename Enum, typename Hash = std::hash<Key>>
+class ConcurrentFlagStore {
+public:
+    using Flags = EnumFlags<Enum>;
+    using RawType = Flags::RawType;
+
+    /**
+     * @brief Create an empty store.
+     *
+     * @param shard_count The number of shards, rounded up to a power of two.
+     */
+    explicit ConcurrentFlagStore(const std::size_t shard_count = 64) :
+        shards_(std::bit_ceil(std::max<std::size_t>(shard_count, 1))) {}
+
+    ConcurrentFlagStore(const ConcurrentFlagStore&) = delete;
+
+    ConcurrentFlagStore& operator=(const ConcurrentFlagStore&) = delete;
+
+    //! Get the number of keys.
+    std::size_t Size() const noexcept {
+        std::size_t size {0};
+        for (const auto& shard : shards_) {
+            size += shard.size.load(std::memory_order_relaxed);
+        }
+
+        return size;
+    }
+
+    //! Check whether a key exists.
+    bool Contains(const Key& key) const noexcept {
+        return Find(key) != nullptr;
+    }
+
+    //! Get the flags of a key, or nothing if it does not exist.
+    std::optional<Flags> Get(const Key& key) const noexcept {
+        if (const auto node {Find(key)}; node != nullptr) {
+            return node->flags.load(std::memory_order_acquire);
+        } else {
+            return std::nullopt;
+        }
+    }
+
+    /**
+     * @brief Add specific flags to a key, inserting it if it does not exist.
+     *
+     * @return The previous flags.
+     */
+    Flags Add(const Key& key, const Flags flags) {
+        return FindOrInsert(key).flags.fetch_or(flags, std::memory_order_acq_rel);
+    }
+
+    /**
+     * @brief Remove specific flags from a key, if it exists.
+     *
+     * @return The previous flags.
+     */
+    Flags Remove(const Key& key, const Flags flags) noexcept {
+        if (const auto node {Find(key)}; node != nullptr) {
+            return node->flags.fetch_and(static_cast<RawType>(~static_cast<RawType>(flags)),
+                                         std::memory_order_acq_rel);
+        } else {
+            return {};
+        }
+    }
+
+    /**
+     * @brief Add specific flags to a key, inserting it if it does not exist.
+     *
+     * @return Whether all specific flags were already set.
+     */
+    bool TestAndAdd(const Key& key, const Flags flags) {
+        return Add(key, flags).HasAll(flags);
+    }
+
+    /**
+     * @brief Call a function with each key and its flags, processing shards in parallel.
+     *
+     * @details
+     * Entries inserted or updated during the scan may or may not be visited with their new flags.
+     *
+     * @param func A thread-safe function called with a key and its flags.
+     * @param thread_count The maximum number of threads.
+     */
+    template <typename Func>
+    void ForEach(Func&& func, const std::size_t thread_count = DefaultThreadCount()) const {
+        ParallelFor(
+            shards_.size(),
+            [this, &func](const std::size_t begin, const std::size_t end) {
+                for (auto i {begin}; i != end; ++i) {
+                    shards_[i].ForEach(func);
+                }
+            },
+            thread_count, 1);
+    }
+
+    /**
+     * @brief Get the keys whose flags satisfy a predicate, processing shards in parallel.
+     *
+     * @param pred A thread-safe predicate.
+     * @param thread_count The maximum number of threads.
+     */
+    template <std::predicate<Flags> Pred>
+    std::vector<Key> KeysIf(Pred&& pred,
+                            const std::size_t thread_count = DefaultThreadCount()) const {
+        std::vector<std::vector<Key>> parts(shards_.size());
+        ParallelFor(
+            shards_.size(),
+            [this, &pred, &parts](const std::size_t begin, const std::size_t end) {
+                for (auto i {begin}; i != end; ++i) {
+                    auto& part {parts[i]};
+                    shards_[i].ForEach([&pred, &part](const Key& key, const Flags flags) {
+                        if (pred(flags)) {
+                            part.push_back(key);
+                        }
+                    });
+                }
+            },
+            thread_count, 1);
+
+        std::vector<Key> keys;
+        for (auto& part : parts) {
+            keys.insert(keys.end(), std::make_move_iterator(part.begin()),
+                        std::make_move_iterator(part.end()));
+        }
+
+        return keys;
+    }
+
+    //! Get the keys having all specific flags set.
+    std::vector<Key> KeysWithAll(const Flags flags,
+                                 const std::size_t thread_count = DefaultThreadCount()) const {
+        return KeysIf([flags](const Flags f) noexcept { return f.HasAll(flags); }, thread_count);
+    }
+
+    //! Get the keys having at least one of the specific flags set.
+    std::vector<Key> KeysWithAny(const Flags flags,
+                                 const std::size_t thread_count = DefaultThreadCount()) const {
+        return KeysIf([flags](const Flags f) noexcept { return f.HasAny(flags); }, thread_count);
+    }
+
+private:
+    struct Node {
+        explicit Node(const Key& key) : key {key} {}
+
+        const Key key;
+        std::atomic<RawType> flags {0};
+    };
+
+    struct Table {
+        explicit Table(const std::size_t capacity) :
+            mask {capacity - 1}, slots {std::make_unique<std::atomic<Node*>[]>(capacity)} {}
+
+        const std::size_t mask;
+        std::unique_ptr<std::atomic<Node*>[]> slots;
+    };
+
+    struct alignas(cache_line_size) Shard {
+        static constexpr std::size_t min_capacity {16};
+
+        Shard() {
+            tables.push_back(std::make_unique<Table>(min_capacity));
+            table.store(tables.back().get(), std::memory_order_relaxed);
+        }
+
+        Node* Find(const Key& key, const std::size_t hash) const noexcept {
+            const auto& t {*table.load(std::memory_order_acquire)};
+            for (auto i {hash & t.mask};; i = (i + 1) & t.mask) {
+                const auto node {t.slots[i].load(std::memory_order_acquire)};
+                if (node == nullptr || node->key == key) {
+                    return node;
+                }
+            }
+        }
+
+        //! Insert a key if it does not exist. It must be called with the shard locked.
+        Node& Insert(const Key& key, const std::size_t hash) {
+            if (const auto node {Find(key, hash)}; node != nullptr) {
+                return *node;
+            }
+
+            const auto& curr {*table.load(std::memory_order_relaxed)};
+            const auto count {size.load(std::memory_order_relaxed)};
+            if ((count + 1) * 4 > (curr.mask + 1) * 3) {
+                Grow(curr);
+            }
+
+            auto& node {nodes.emplace_back(key)};
+            Place(*table.load(std::memory_order_relaxed), node, hash);
+            size.store(count + 1, std::memory_order_relaxed);
+            return node;
+        }
+
+        template <typename Func>
+        void ForEach(Func&& func) const {
+            const auto& t {*table.load(std::memory_order_acquire)};
+            for (std::size_t i {0}; i <= t.mask; ++i) {
+                if (const auto node {t.slots[i].load(std::memory_order_acquire)}; node != nullptr) {
+                    func(node->key, Flags {node->flags.load(std::memory_order_acquire)});
+                }
+            }
+        }
+
+        std::mutex mtx;
+        std::atomic<Table*> table;
+
+        //! The current table and older tables that readers may still be probing.
+        std::vector<std::unique_ptr<Table>> tables;
+
+        //! Entries, with addresses stable across resizes.
+        std::deque<Node> nodes;
+
+        std::atomic_size_t size {0};
+
+    private:
+        static void Place(Table& t, Node& node, const std::size_t hash) noexcept {
+            auto i {hash & t.mask};
+            while (t.slots[i].load(std::memory_order_relaxed) != nullptr) {
+                i = (i + 1) & t.mask;
+            }
+
+            t.slots[i].store(&node, std::memory_order_release);
+        }
+
+        void Grow(const Table& old) {
+            auto bigger {std::make_unique<Table>((old.mask + 1) * 2)};
+            for (auto& node : nodes) {
+                Place(*bigger, node, Mix(Hash {}(node.key)));
+            }
+
+            table.store(bigger.get(), std::memory_order_release);
+            tables.push_back(std::move(bigger));
+        }
+    };
+
+    static std::size_t Mix(const std::size_t hash) noexcept {
+        // The upper bits select a shard and the lower bits select a slot.
+        auto h {static_cast<std::uint64_t>(hash)};
+        h = (h ^ (h >> 33)) * 0xFF51AFD7ED558CCD;
+        h = (h ^ (h >> 33)) * 0xC4CEB9FE1A85EC53;
+        return static_cast<std::size_t>(h ^ (h >> 33));
+    }
+
+    std::size_t ShardIndex(const std::size_t hash) const noexcept {
+        // The top 16 bits select a shard, whatever the width of `std::size_t`.
+        return (hash >> (std::numeric_limits<std::size_t>::digits - 16)) & (shards_.size() - 1);
+    }
+
+    Node* Find(const Key& key) const noexcept {
+        const auto hash {Mix(Hash {}(key))};
+        return shards_[ShardIndex(hash)].Find(key, hash);
+    }
+
+    Node& FindOrInsert(const Key& key) {
+        const auto hash {Mix(Hash {}(key))};
+        auto& shard {shards_[ShardIndex(hash)]};
+        if (const auto node {shard.Find(key, hash)}; node != nullptr) {
+            return *node;
+        }
+
+        const std::lock_guard lock {shard.mtx};
+        return shard.Insert(key, hash);
+    }
+
+    std::vector<Shard> shards_;
+};
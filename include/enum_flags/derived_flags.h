@@ -0,0 +1,217 @@
+/**
+ * @file derived_flags.h
+ * @brief @p EnumFlags with derived flags maintained incrementally from base flags.
+ *
+ * @details
+ * A derived flag is declared as a compile-time expression over flags in the same word:
+ *
+ * @code {.cpp}
+ * using Health = DerivedFlags<
+ *     Opt, DerivedFlag<Opt::Healthy,
+ *                      FlagAnd<FlagIs<Opt::Connected>, FlagNot<FlagIs<Opt::Degraded>>,
+ *                              FlagIs<Opt::Synced>>>>;
+ * @endcode
+ *
+ * The dependency mask of each expression is computed at compile time.
+ * An update only re-evaluates the derived flags whose dependencies have changed,
+ * so reading a derived flag is a single @p Has.
+ *
+ * A derived flag may depend on derived flags declared before it.
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ */
+
+#pragma once
+
+#include "enum_flags.h"
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+//! An expression true if a flag is set.
+template <auto Flag>
+    requires std::is_scoped_enum_v<decltype(Flag)>
+struct FlagIs {
+    using RawType = std::underlying_type_t<decltype(Flag)>;
+
+    static constexpr RawType dependencies {std::to_underlying(Flag)};
+
+    static constexpr bool Evaluate(const RawType flags) noexcept {
+        return (flags & dependencies) == dependencies;
+    }
+};
+
+//! An expression negating another expression.
+template <typename Expr>
+struct FlagNot {
+    using RawType = Expr::RawType;
+
+    static constexpr RawType dependencies {Expr::dependencies};
+
+    static constexpr bool Evaluate(const RawType flags) noexcept {
+        return !Expr::Evaluate(flags);
+    }
+};
+
+//! An expression true if all sub-expressions are true.
+template <typename... Exprs>
+    requires(sizeof...(Exprs) > 0)
+struct FlagAnd {
+    using RawType = std::common_type_t<typename Exprs::RawType...>;
+
+    static constexpr RawType dependencies {static_cast<RawType>((Exprs::dependencies | ...))};
+
+    static constexpr bool Evaluate(const RawType flags) noexcept {
+        return (Exprs::Evaluate(flags) && ...);
+    }
+};
+
+//! An expression true if at least one of the sub-expressions is true.
+template <typename... Exprs>
+    requires(sizeof...(Exprs) > 0)
+struct FlagOr {
+    using RawType = std::common_type_t<typename Exprs::RawType...>;
+
+    static constexpr RawType dependencies {static_cast<RawType>((Exprs::dependencies | ...))};
+
+    static constexpr bool Evaluate(const RawType flags) noexcept {
+        return (Exprs::Evaluate(flags) || ...);
+    }
+};
+
+//! A rule setting a derived flag to the value of an expression.
+template <auto Target, typename Expr>
+    requires std::is_scoped_enum_v<decltype(Target)>
+struct DerivedFlag {
+    using Expression = Expr;
+
+    static constexpr std::underlying_type_t<decltype(Target)> target {std::to_underlying(Target)};
+};
+
+//! @p EnumFlags with derived flags maintained incrementally from base flags.
+template <typename Enum, typename... Rules>
+class DerivedFlags {
+public:
+    using Flags = EnumFlags<Enum>;
+    using RawType = Flags::RawType;
+
+    //! All derived flags.
+    static constexpr Flags derived_mask {static_cast<RawType>((RawType {0} | ... | Rules::target))};
+
+    //! Create flags from base flags. Derived flags in @p flags are ignored.
+    explicit constexpr DerivedFlags(const Flags flags = {}) noexcept {
+        Update(flags, static_cast<RawType>(~RawType {0}));
+    }
+
+    //! Get the flags that a derived flag depends on, including indirectly.
+    static constexpr Flags Dependencies(const Enum derived) noexcept {
+        RawType deps {0};
+        for (std::size_t i {rules.size()}; i != 0; --i) {
+            const auto& rule {rules[i - 1]};
+            if ((rule.target & (std::to_underlying(derived) | deps)) != 0) {
+                deps |= rule.dependencies;
+            }
+        }
+
+        return deps;
+    }
+
+    //! Get all flags.
+    constexpr Flags Load() const noexcept {
+        return flags_;
+    }
+
+    //! Check whether a base or derived flag is set.
+    constexpr bool Has(const Enum flag) const noexcept {
+        return flags_.Has(flag);
+    }
+
+    //! Check whether all specific flags are set.
+    constexpr bool HasAll(const Flags flags) const noexcept {
+        return flags_.HasAll(flags);
+    }
+
+    //! Check whether at least one of the specific flags is set.
+    constexpr bool HasAny(const Flags flags) const noexcept {
+        return flags_.HasAny(flags);
+    }
+
+    //! Add specific base flags.
+    constexpr DerivedFlags& Add(const Flags flags) noexcept {
+        return Set(Flags {flags_}.Add(flags));
+    }
+
+    //! Remove specific base flags.
+    constexpr DerivedFlags& Remove(const Flags flags) noexcept {
+        return Set(Flags {flags_}.Remove(flags));
+    }
+
+    //! Reset the base flags. Derived flags in @p flags are ignored.
+    constexpr DerivedFlags& Set(const Flags flags) noexcept {
+        Update(flags, 0);
+        return *this;
+    }
+
+private:
+    struct RuleMasks {
+        RawType target;
+        RawType dependencies;
+    };
+
+    static constexpr std::array<RuleMasks, sizeof...(Rules)> rules {
+        RuleMasks {static_cast<RawType>(Rules::target),
+                   static_cast<RawType>(Rules::Expression::dependencies)}...};
+
+    //! Check that targets are single distinct flags and depend only on earlier flags.
+    static consteval bool IsOrdered() noexcept {
+        auto later {static_cast<RawType>(derived_mask)};
+        for (const auto& rule : rules) {
+            if (std::popcount(rule.target) != 1 || (rule.dependencies & later) != 0) {
+                return false;
+            }
+
+            later &= ~rule.target;
+        }
+
+        return derived_mask.Count() == rules.size();
+    }
+
+    static_assert(IsOrdered(),
+                  "Each derived flag must be a distinct single flag "
+                  "and depend only on base flags or derived flags declared before it.");
+
+    /**
+     * @brief Replace the base flags and re-evaluate affected derived flags.
+     *
+     * @param flags New base flags.
+     * @param dirty Flags to treat as changed even if they are not.
+     */
+    constexpr void Update(const Flags flags, const RawType dirty) noexcept {
+        const auto old {static_cast<RawType>(flags_)};
+        const auto derived {static_cast<RawType>(derived_mask)};
+        auto next {
+            static_cast<RawType>((static_cast<RawType>(flags) & ~derived) | (old & derived))};
+        auto changed {static_cast<RawType>((old ^ next) | dirty)};
+        (Evaluate<Rules>(next, changed), ...);
+        flags_ = next;
+    }
+
+    template <typename Rule>
+    static constexpr void Evaluate(RawType& flags, RawType& changed) noexcept {
+        if ((changed & Rule::Expression::dependencies) == 0) {
+            return;
+        }
+
+        const auto value {Rule::Expression::Evaluate(flags)
+                              ? static_cast<RawType>(flags | Rule::target)
+                              : static_cast<RawType>(flags & ~Rule::target)};
+        changed |= flags ^ value;
+        flags = value;
+    }
+
+    Flags flags_;
+};
@@ -8,6 +8,12 @@
  * - Setting and clearing individual or multiple flags.
  * - Checking if any or multiple flags are set.
  * - Combining multiple flags into a single flag.
+ * - Counting and iterating set flags.
+ * - Knowing the valid flags of an enumeration, to complement flags and strip stray bits.
+ * - Being used as a non-type template parameter, such as @p Pipeline<EnumFlags<Stage>{Stage::A}>.
+ *
+ * Valid flags are reflected from enumerators on GCC, Clang and MSVC only.
+ * On other compilers, enumerations must specialize @ref EnumFlagsTraits.
  *
  * @par GitHub
  * https://github.com/Zhuagenborn
@@ -16,25 +22,154 @@
 #pragma once
 
 #include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstddef>
 #include <initializer_list>
+#include <limits>
 #include <ranges>
+#include <source_location>
+#include <string_view>
 #include <type_traits>
 #include <utility>
 
+/**
+ * @brief Declare the valid flags of an enumeration explicitly.
+ *
+ * @details
+ * Specialize it with a @p valid_mask member of the underlying type:
+ *
+ * @code {.cpp}
+ * template <>
+ * struct EnumFlagsTraits<Opt> {
+ *     static constexpr unsigned int valid_mask {0b111};
+ * };
+ * @endcode
+ *
+ * Otherwise, the valid flags are reflected from the enumerators, see @ref FlagTraits.
+ *
+ * An enumeration shared between processes also declares a unique @p name,
+ * see @ref SharedFlagsSegment.
+ */
+template <typename Enum>
+struct EnumFlagsTraits;
+
+/**
+ * @brief Check whether a value of an enumeration has a name, by parsing a compiler's function name.
+ *
+ * @details
+ * It supports GCC, Clang and MSVC.
+ * Other compilers fail to compile it, so their enumerations must specialize @ref EnumFlagsTraits.
+ */
+template <auto Value>
+consteval bool IsNamedEnumerator() noexcept {
+#if defined(_MSC_VER) && !defined(__clang__)
+    // The value is printed as a template argument, such as `IsNamedEnumerator<Opt::A>(void)`.
+    // An unnamed value is printed as a cast, such as `IsNamedEnumerator<(enum Opt)0x8>(void)`.
+    const std::string_view name {__FUNCSIG__};
+    constexpr std::string_view key {"IsNamedEnumerator<"};
+    const auto begin {name.find(key)};
+    if (begin == std::string_view::npos) {
+        // An unknown format. Assume that every value has a name.
+        return true;
+    }
+
+    return name.substr(begin + key.size()).front() != '(';
+#elif defined(__GNUC__) || defined(__clang__)
+    const std::string_view name {std::source_location::current().function_name()};
+    constexpr std::string_view key {"Value = "};
+    const auto begin {name.find(key)};
+    if (begin == std::string_view::npos) {
+        // An unknown format. Assume that every value has a name.
+        return true;
+    }
+
+    // An unnamed value is printed as a cast, such as `(Opt)8`.
+    auto value {name.substr(begin + key.size())};
+    value = value.substr(0, value.find_first_of(";]"));
+    const auto paren {value.rfind(')')};
+    return paren == std::string_view::npos
+           || value.find_first_not_of("0123456789uUlL", paren + 1) != std::string_view::npos;
+#else
+    static_assert(!std::is_same_v<decltype(Value), decltype(Value)>,
+                  "Enumerators cannot be reflected on this compiler. "
+                  "Specialize `EnumFlagsTraits` to declare the valid flags.");
+    return true;
+#endif
+}
+
+/**
+ * @brief Metadata about the valid flags of an enumeration.
+ *
+ * @details
+ * The valid flags come from @ref EnumFlagsTraits if it is specialized.
+ * Otherwise, every bit named by an enumerator is valid.
+ * If no bit is named, every bit is valid.
+ */
+template <typename Enum>
+    requires std::is_scoped_enum_v<Enum> && std::unsigned_integral<std::underlying_type_t<Enum>>
+struct FlagTraits {
+    using RawType = std::underlying_type_t<Enum>;
+
+private:
+    template <std::size_t... Bits>
+    static consteval RawType ReflectValidMask(std::index_sequence<Bits...>) noexcept {
+        return static_cast<RawType>(
+            (RawType {0} | ...
+             | (IsNamedEnumerator<static_cast<Enum>(RawType {1} << Bits)>() ? RawType {1} << Bits
+                                                                            : RawType {0})));
+    }
+
+    static consteval RawType FindValidMask() noexcept {
+        if constexpr (requires { EnumFlagsTraits<Enum>::valid_mask; }) {
+            return EnumFlagsTraits<Enum>::valid_mask;
+        } else {
+            constexpr auto mask {ReflectValidMask(
+                std::make_index_sequence<std::numeric_limits<RawType>::digits> {})};
+            return mask != 0 ? mask : std::numeric_limits<RawType>::max();
+        }
+    }
+
+public:
+    //! All valid flags.
+    static constexpr RawType valid_mask {FindValidMask()};
+
+    static_assert(valid_mask != 0, "An enumeration must have at least one valid flag.");
+
+    //! The number of valid flags.
+    static constexpr std::size_t count {static_cast<std::size_t>(std::popcount(valid_mask))};
+
+    //! The index of the highest valid flag.
+    static constexpr std::size_t max_bit {
+        static_cast<std::size_t>(std::numeric_limits<RawType>::digits - 1
+                                 - std::countl_zero(valid_mask))};
+
+    //! The number of bits up to the highest valid flag, which bounds loops over bits.
+    static constexpr std::size_t bit_width {max_bit + 1};
+
+    //! Whether the valid flags are the lowest consecutive bits.
+    static constexpr bool is_dense {count == bit_width};
+};
+
 //! The type-safe bit flag manager for C++11 scoped enumerations.
 template <typename Enum>
     requires std::is_scoped_enum_v<std::decay_t<Enum>>
              && std::unsigned_integral<std::underlying_type_t<std::decay_t<Enum>>>
 class EnumFlags {
+public:
     //! The underlying type of the enumeration.
     using RawType = std::underlying_type_t<std::decay_t<Enum>>;
 
-public:
     //! Create an enumeration flag value.
     static consteval RawType CreateFlag(const std::size_t shift) noexcept {
         return static_cast<RawType>(1) << shift;
     }
 
+    //! Get all valid flags.
+    static constexpr EnumFlags All() noexcept {
+        return FlagTraits<std::decay_t<Enum>>::valid_mask;
+    }
+
     auto operator<=>(const EnumFlags&) = delete;
 
     //! Construct flags from an initializer list of enumeration values.
@@ -50,47 +185,84 @@ public:
     }
 
     //! Construct flags from a underlying-type value.
-    constexpr EnumFlags(const RawType flags = 0) noexcept : flags_ {flags} {}
+    constexpr EnumFlags(const RawType flags = 0) noexcept : value {flags} {}
 
     //! Construct flags from an enumeration value.
-    constexpr EnumFlags(const Enum flag) noexcept : flags_ {std::to_underlying(flag)} {}
+    constexpr EnumFlags(const Enum flag) noexcept : value {std::to_underlying(flag)} {}
 
     //! Clear all flags.
     constexpr EnumFlags& Clear() noexcept {
-        flags_ = 0;
+        value = 0;
         return *this;
     }
 
     //! Remove specific flags.
     constexpr EnumFlags& Remove(const EnumFlags flags) noexcept {
-        flags_ &= ~static_cast<RawType>(flags);
+        value &= ~static_cast<RawType>(flags);
         return *this;
     }
 
     //! Add specific flags.
     constexpr EnumFlags& Add(const EnumFlags flags) noexcept {
-        flags_ |= static_cast<RawType>(flags);
+        value |= static_cast<RawType>(flags);
+        return *this;
+    }
+
+    //! Remove bits that are not valid flags.
+    constexpr EnumFlags& Sanitize() noexcept {
+        value &= static_cast<RawType>(All());
         return *this;
     }
 
+    //! Create a new @p EnumFlags with the valid flags that are not set.
+    constexpr EnumFlags Complement() const noexcept {
+        return static_cast<RawType>(~value & static_cast<RawType>(All()));
+    }
+
     //! Check whether a flag is set.
     constexpr bool Has(const Enum flag) const noexcept {
-        return (flags_ & std::to_underlying(flag)) != 0;
+        return (value & std::to_underlying(flag)) != 0;
     }
 
     //! Check whether all specific flags are set.
     constexpr bool HasAll(const EnumFlags flags) const noexcept {
-        return (flags_ & static_cast<RawType>(flags)) == static_cast<RawType>(flags);
+        return (value & static_cast<RawType>(flags)) == static_cast<RawType>(flags);
     }
 
     //! Check whether at least one of the specific flags is set.
     constexpr bool HasAny(const EnumFlags flags) const noexcept {
-        return (flags_ & static_cast<RawType>(flags)) != 0;
+        return (value & static_cast<RawType>(flags)) != 0;
     }
 
     //! Check whether any flags are set.
     constexpr bool HasAny() const noexcept {
-        return flags_ != 0;
+        return value != 0;
+    }
+
+    //! Check whether only valid flags are set.
+    constexpr bool IsValid() const noexcept {
+        return (value & ~static_cast<RawType>(All())) == 0;
+    }
+
+    //! Get the number of set flags.
+    constexpr std::size_t Count() const noexcept {
+        return static_cast<std::size_t>(std::popcount(value));
+    }
+
+    //! Call a function with the index of each set bit, from the lowest to the highest.
+    template <std::invocable<std::size_t> Func>
+    constexpr void ForEachBit(Func&& func) const {
+        for (auto bits {value}; bits != 0; bits &= bits - 1) {
+            func(static_cast<std::size_t>(std::countr_zero(bits)));
+        }
+    }
+
+    //! Call a function with each set flag, from the lowest bit to the highest.
+    template <std::invocable<Enum> Func>
+    constexpr void ForEach(Func&& func) const {
+        for (auto bits {value}; bits != 0; bits &= bits - 1) {
+            func(static_cast<Enum>(bits & static_cast<RawType>(~bits + 1)));
+        }
     }
 
     //! Same as @ref Has.
@@ -105,7 +277,7 @@ public:
 
     //! Reset the current flags to specific flags.
     constexpr EnumFlags& operator&=(const EnumFlags flags) noexcept {
-        flags_ = flags;
+        value = flags;
         return *this;
     }
 
@@ -119,25 +291,38 @@ public:
         return Add(flags);
     }
 
+    //! Same as @ref Complement.
+    constexpr EnumFlags operator~() const noexcept {
+        return Complement();
+    }
+
     //! Get the underlying value.
     constexpr operator RawType() const noexcept {
-        return flags_;
+        return value;
     }
 
     constexpr void swap(EnumFlags& flags) noexcept {
-        std::ranges::swap(flags_, flags.flags_);
+        std::ranges::swap(value, flags.value);
     }
 
     constexpr bool operator==(const EnumFlags&) const noexcept = default;
 
+    /**
+     * @brief The underlying value.
+     *
+     * @details
+     * It is public only to make @p EnumFlags a structural type,
+     * which a non-type template parameter requires.
+     * Writing to it directly is unsupported. Use the member functions or constructors instead.
+     */
+    RawType value {0};
+
 private:
     template <std::ranges::range Flags>
         requires std::same_as<Enum, std::ranges::range_value_t<Flags>>
     constexpr void AddFlags(const Flags& flags) noexcept {
         std::ranges::for_each(flags, [this](const auto flag) noexcept { Add(flag); });
     }
-
-    RawType flags_ {0};
 };
 
 template <typename Enum>
@@ -0,0 +1,374 @@
+/**
+ * @file flag_codecs.h
+ * @brief Compressed encodings for sequences of @p EnumFlags.
+ *
+ * @details
+ * A block of flags can be encoded with one of the following codecs:
+ *
+ * - Raw values.
+ * - Run-length encoding: distinct consecutive values with bit-packed run lengths.
+ * - Delta-XOR encoding: the first value followed by bit-packed XORs with the previous value.
+ * - Dictionary encoding: distinct values followed by bit-packed dictionary indices.
+ *
+ * The adaptive encoder collects cheap statistics in a single pass and picks the smallest codec.
+ * Predicates can be counted on encoded blocks without decoding them into a buffer.
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ */
+
+#pragma once
+
+#include "enum_flags.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+//! Codecs for blocks of flags.
+enum class FlagCodec : std::uint8_t { Raw, RunLength, DeltaXor, Dictionary };
+
+//! A block of @p EnumFlags encoded with a @ref FlagCodec.
+template <typename Enum>
+class EncodedFlags {
+public:
+    using Flags = EnumFlags<Enum>;
+    using RawType = Flags::RawType;
+
+    //! The maximum number of distinct values for which the adaptive encoder considers a dictionary.
+    static constexpr std::size_t max_dictionary_size {64};
+
+    //! Encode flags with the codec producing the smallest block.
+    static EncodedFlags Encode(const std::span<const Flags> flags) {
+        return Encode(flags, ChooseCodec(flags));
+    }
+
+    //! Encode flags with a specific codec.
+    static EncodedFlags Encode(const std::span<const Flags> flags, const FlagCodec codec) {
+        EncodedFlags block;
+        block.codec_ = codec;
+        block.size_ = flags.size();
+        if (flags.empty()) {
+            return block;
+        }
+
+        switch (codec) {
+            case FlagCodec::Raw: {
+                block.values_.assign(flags.begin(), flags.end());
+                break;
+            }
+            case FlagCodec::RunLength: {
+                std::vector<std::size_t> lengths;
+                for (const auto flag : flags) {
+                    if (block.values_.empty() || block.values_.back() != flag) {
+                        block.values_.push_back(flag);
+                        lengths.push_back(0);
+                    }
+
+                    ++lengths.back();
+                }
+
+                block.width_ = BitWidth(std::ranges::max(lengths));
+                block.Pack(lengths);
+                break;
+            }
+            case FlagCodec::DeltaXor: {
+                block.values_.push_back(flags.front());
+                std::vector<std::uint64_t> deltas;
+                deltas.reserve(flags.size() - 1);
+                RawType bits {0};
+                for (std::size_t i {1}; i != flags.size(); ++i) {
+                    deltas.push_back(static_cast<RawType>(flags[i] ^ flags[i - 1]));
+                    bits |= static_cast<RawType>(deltas.back());
+                }
+
+                block.width_ = BitWidth(bits);
+                block.Pack(deltas);
+                break;
+            }
+            case FlagCodec::Dictionary: {
+                block.values_.assign(flags.begin(), flags.end());
+                std::ranges::sort(block.values_, std::ranges::less {}, ToRaw);
+                const auto [first, last] {std::ranges::unique(block.values_)};
+                block.values_.erase(first, last);
+                std::vector<std::size_t> indices;
+                indices.reserve(flags.size());
+                for (const auto flag : flags) {
+                    indices.push_back(static_cast<std::size_t>(
+                        std::ranges::lower_bound(block.values_, static_cast<RawType>(flag),
+                                                 std::ranges::less {}, ToRaw)
+                        - block.values_.begin()));
+                }
+
+                block.width_ = BitWidth(block.values_.size() - 1);
+                block.Pack(indices);
+                break;
+            }
+        }
+
+        return block;
+    }
+
+    //! Choose the codec producing the smallest block from single-pass statistics.
+    static FlagCodec ChooseCodec(const std::span<const Flags> flags) noexcept {
+        if (flags.empty()) {
+            return FlagCodec::Raw;
+        }
+
+        std::size_t runs {1};
+        std::size_t run {1};
+        std::size_t max_run {1};
+        RawType xor_bits {0};
+        std::array<Flags, max_dictionary_size> dict {flags.front()};
+        std::size_t dict_size {1};
+        for (std::size_t i {1}; i != flags.size(); ++i) {
+            const auto delta {static_cast<RawType>(flags[i] ^ flags[i - 1])};
+            xor_bits |= delta;
+            if (delta == 0) {
+                max_run = std::max(max_run, ++run);
+                continue;
+            }
+
+            ++runs;
+            run = 1;
+            if (dict_size != 0) {
+                const auto end {dict.begin() + dict_size};
+                if (std::ranges::find(dict.begin(), end, flags[i]) == end) {
+                    if (dict_size == max_dictionary_size) {
+                        dict_size = 0;
+                    } else {
+                        dict[dict_size++] = flags[i];
+                    }
+                }
+            }
+        }
+
+        const auto n {flags.size()};
+        auto best {FlagCodec::Raw};
+        auto best_bytes {EstimateBytes(n, 0, 0)};
+        const auto consider {[&best, &best_bytes](const FlagCodec codec,
+                                                  const std::size_t bytes) noexcept {
+            if (bytes < best_bytes) {
+                best = codec;
+                best_bytes = bytes;
+            }
+        }};
+
+        consider(FlagCodec::RunLength, EstimateBytes(runs, runs, BitWidth(max_run)));
+        consider(FlagCodec::DeltaXor, EstimateBytes(1, n - 1, BitWidth(xor_bits)));
+        if (dict_size != 0) {
+            consider(FlagCodec::Dictionary, EstimateBytes(dict_size, n, BitWidth(dict_size - 1)));
+        }
+
+        return best;
+    }
+
+    //! Get the codec of the block.
+    FlagCodec Codec() const noexcept {
+        return codec_;
+    }
+
+    //! Get the number of encoded flags.
+    std::size_t Size() const noexcept {
+        return size_;
+    }
+
+    //! Get the number of bytes used by the encoded data.
+    std::size_t EncodedBytes() const noexcept {
+        return values_.size() * sizeof(Flags) + packed_.size() * sizeof(std::uint64_t);
+    }
+
+    /**
+     * @brief Decode the block into a buffer.
+     *
+     * @param out A buffer of at least @ref Size elements.
+     */
+    void Decode(const std::span<Flags> out) const noexcept {
+        std::size_t i {0};
+        Visit([&out, &i](const Flags flags, const std::size_t count) noexcept {
+            std::ranges::fill_n(out.begin() + i, count, flags);
+            i += count;
+        });
+    }
+
+    //! Decode the block into a new vector.
+    std::vector<Flags> Decode() const {
+        std::vector<Flags> flags(size_);
+        Decode(flags);
+        return flags;
+    }
+
+    /**
+     * @brief Count the flags satisfying a predicate.
+     *
+     * @details
+     * Run-length blocks evaluate the predicate once per run.
+     * Dictionary blocks evaluate it once per distinct value and then only scan the indices.
+     */
+    template <std::predicate<Flags> Pred>
+    std::size_t CountIf(Pred&& pred) const {
+        if (codec_ == FlagCodec::Dictionary) {
+            std::vector<bool> matches;
+            matches.reserve(values_.size());
+            for (const auto flags : values_) {
+                matches.push_back(pred(flags));
+            }
+
+            std::size_t count {0};
+            for (std::size_t i {0}; i != size_; ++i) {
+                count += matches[Unpack(i)];
+            }
+
+            return count;
+        }
+
+        std::size_t count {0};
+        Visit([&pred, &count](const Flags flags, const std::size_t repeat) {
+            if (pred(flags)) {
+                count += repeat;
+            }
+        });
+
+        return count;
+    }
+
+    //! Count the flags having all specific flags set.
+    std::size_t CountHasAll(const Flags flags) const {
+        return CountIf([flags](const Flags f) noexcept { return f.HasAll(flags); });
+    }
+
+    //! Count the flags having at least one of the specific flags set.
+    std::size_t CountHasAny(const Flags flags) const {
+        return CountIf([flags](const Flags f) noexcept { return f.HasAny(flags); });
+    }
+
+private:
+    static constexpr std::size_t word_bits {std::numeric_limits<std::uint64_t>::digits};
+
+    static constexpr RawType ToRaw(const Flags flags) noexcept {
+        return flags;
+    }
+
+    static constexpr std::uint8_t BitWidth(const std::uint64_t value) noexcept {
+        return static_cast<std::uint8_t>(std::bit_width(value));
+    }
+
+    //! Estimate the encoded size of a block with some full values and some packed integers.
+    static constexpr std::size_t EstimateBytes(const std::size_t values, const std::size_t ints,
+                                               const std::uint8_t width) noexcept {
+        return values * sizeof(Flags)
+               + (ints * width + word_bits - 1) / word_bits * sizeof(std::uint64_t);
+    }
+
+    template <typename Int>
+    void Pack(const std::vector<Int>& ints) {
+        packed_.assign((ints.size() * width_ + word_bits - 1) / word_bits, 0);
+        if (width_ == 0) {
+            return;
+        }
+
+        for (std::size_t i {0}; i != ints.size(); ++i) {
+            const auto value {static_cast<std::uint64_t>(ints[i])};
+            const auto bit {i * width_};
+            const auto word {bit / word_bits};
+            const auto offset {bit % word_bits};
+            packed_[word] |= value << offset;
+            if (offset + width_ > word_bits) {
+                packed_[word + 1] |= value >> (word_bits - offset);
+            }
+        }
+    }
+
+    std::uint64_t Unpack(const std::size_t i) const noexcept {
+        if (width_ == 0) {
+            return 0;
+        }
+
+        const auto bit {i * width_};
+        const auto word {bit / word_bits};
+        const auto offset {bit % word_bits};
+        auto value {packed_[word] >> offset};
+        if (offset + width_ > word_bits) {
+            value |= packed_[word + 1] << (word_bits - offset);
+        }
+
+        return width_ == word_bits ? value : value & ((std::uint64_t {1} << width_) - 1);
+    }
+
+    //! Call a function with each stored value and its number of consecutive repeats.
+    template <typename Func>
+    void Visit(Func&& func) const {
+        if (size_ == 0) {
+            return;
+        }
+
+        switch (codec_) {
+            case FlagCodec::Raw: {
+                for (const auto flags : values_) {
+                    func(flags, 1);
+                }
+
+                break;
+            }
+            case FlagCodec::RunLength: {
+                for (std::size_t i {0}; i != values_.size(); ++i) {
+                    func(values_[i], static_cast<std::size_t>(Unpack(i)));
+                }
+
+                break;
+            }
+            case FlagCodec::DeltaXor: {
+                auto flags {values_.front()};
+                func(flags, 1);
+                for (std::size_t i {0}; i + 1 != size_; ++i) {
+                    flags = static_cast<RawType>(flags ^ static_cast<RawType>(Unpack(i)));
+                    func(flags, 1);
+                }
+
+                break;
+            }
+            case FlagCodec::Dictionary: {
+                for (std::size_t i {0}; i != size_; ++i) {
+                    func(values_[Unpack(i)], 1);
+                }
+
+                break;
+            }
+        }
+    }
+
+    FlagCodec codec_ {FlagCodec::Raw};
+    std::size_t size_ {0};
+    std::uint8_t width_ {0};
+
+    //! Raw values, run values, the first value or dictionary entries, depending on the codec.
+    std::vector<Flags> values_;
+
+    //! Bit-packed run lengths, XOR deltas or dictionary indices, depending on the codec.
+    std::vector<std::uint64_t> packed_;
+};
+
+/**
+ * @brief Split flags into fixed-size blocks and encode each block with its own codec.
+ *
+ * @param flags Flags.
+ * @param block_size The maximum number of flags in a block.
+ */
+template <typename Enum>
+std::vector<EncodedFlags<Enum>> EncodeFlagBlocks(const std::span<const EnumFlags<Enum>> flags,
+                                                 const std::size_t block_size) {
+    const auto size {std::max<std::size_t>(block_size, 1)};
+    std::vector<EncodedFlags<Enum>> blocks;
+    blocks.reserve((flags.size() + size - 1) / size);
+    for (std::size_t i {0}; i < flags.size(); i += size) {
+        const auto block {flags.subspan(i, std::min(size, flags.size() - i))};
+        blocks.push_back(EncodedFlags<Enum>::Encode(block));
+    }
+
+    return blocks;
+}
@@ -0,0 +1,172 @@
+/**
+ * @file flag_constraints.h
+ * @brief Constraints on @p EnumFlags compiled to masks and validated without branches.
+ *
+ * @details
+ * Every constraint is reduced to the same form:
+ * if any trigger flag is set, or there are no trigger flags,
+ * the number of set flags in a group must lie within a range.
+ *
+ * - Exactly one of a group: no trigger, range <tt>[1, 1]</tt>.
+ * - At most one of a group: no trigger, range <tt>[0, 1]</tt>.
+ * - A flag requiring others: the flag as the trigger and the others as the group,
+ *   whose size is the only allowed count.
+ * - A flag excluding others: range <tt>[0, 0]</tt>.
+ *
+ * Validation evaluates all constraints with AND, popcount and compare operations,
+ * and collects violations into a bitmap.
+ *
+ * @code {.cpp}
+ * constexpr auto constraints {FlagConstraints<Opt> {}
+ *                                 .ExactlyOne({Opt::ModeA, Opt::ModeB, Opt::ModeC})
+ *                                 .AtMostOne({Opt::Gzip, Opt::Zstd})
+ *                                 .Requires(Opt::Encrypted, Opt::Signed)};
+ * @endcode
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ */
+
+#pragma once
+
+#include "enum_flags.h"
+#include "parallel.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+//! Constraints on @p EnumFlags compiled to masks.
+template <typename Enum>
+class FlagConstraints {
+public:
+    using Flags = EnumFlags<Enum>;
+    using RawType = Flags::RawType;
+
+    //! The maximum number of constraints, one bit each in a violation bitmap.
+    static constexpr std::size_t max_constraints {std::numeric_limits<std::uint64_t>::digits};
+
+    constexpr FlagConstraints() noexcept = default;
+
+    //! Get the number of constraints.
+    constexpr std::size_t Size() const noexcept {
+        return size_;
+    }
+
+    //! Require exactly one flag of a group to be set.
+    constexpr FlagConstraints& ExactlyOne(const Flags group) {
+        return Add(0, group, 1, 1);
+    }
+
+    //! Allow at most one flag of a group to be set.
+    constexpr FlagConstraints& AtMostOne(const Flags group) {
+        return Add(0, group, 0, 1);
+    }
+
+    //! Require at least one flag of a group to be set.
+    constexpr FlagConstraints& AtLeastOne(const Flags group) {
+        return Add(0, group, 1, group.Count());
+    }
+
+    //! Require all specific flags to be set if any trigger flag is set.
+    constexpr FlagConstraints& Requires(const Flags trigger, const Flags required) {
+        return Add(trigger, required, required.Count(), required.Count());
+    }
+
+    //! Require all specific flags to be cleared if any trigger flag is set.
+    constexpr FlagConstraints& Excludes(const Flags trigger, const Flags excluded) {
+        return Add(trigger, excluded, 0, 0);
+    }
+
+    /**
+     * @brief Get the violated constraints.
+     *
+     * @return A bitmap where bit @p i is set if the @p i-th declared constraint is violated.
+     */
+    constexpr std::uint64_t Violations(const Flags flags) const noexcept {
+        const auto raw {static_cast<RawType>(flags)};
+        std::uint64_t violations {0};
+        for (std::size_t i {0}; i != size_; ++i) {
+            const auto& c {constraints_[i]};
+            const auto active {(c.trigger == 0) | ((raw & c.trigger) != 0)};
+            const auto count {
+                static_cast<unsigned>(std::popcount(static_cast<RawType>(raw & c.group)))};
+            const auto violated {
+                static_cast<std::uint64_t>(active & ((count < c.min) | (count > c.max)))};
+            violations |= violated << i;
+        }
+
+        return violations;
+    }
+
+    //! Check whether flags satisfy all constraints.
+    constexpr bool Validate(const Flags flags) const noexcept {
+        return Violations(flags) == 0;
+    }
+
+    /**
+     * @brief Validate flags in bulk.
+     *
+     * @param flags Rows of flags.
+     * @param thread_count The maximum number of threads.
+     * @return A bitmap with one bit per row, set if the row violates a constraint.
+     * Row @p i is bit <tt>i % 64</tt> of word <tt>i / 64</tt>.
+     */
+    std::vector<std::uint64_t> ValidateEach(
+        const std::span<const Flags> flags,
+        const std::size_t thread_count = DefaultThreadCount()) const {
+        std::vector<std::uint64_t> invalid((flags.size() + word_bits - 1) / word_bits);
+        ParallelFor(
+            invalid.size(),
+            [this, flags, &invalid](const std::size_t begin, const std::size_t end) {
+                for (auto word {begin}; word != end; ++word) {
+                    const auto rows {flags.subspan(word * word_bits).first(
+                        std::min(word_bits, flags.size() - word * word_bits))};
+                    std::uint64_t bits {0};
+                    for (std::size_t i {0}; i != rows.size(); ++i) {
+                        bits |= std::uint64_t {Violations(rows[i]) != 0} << i;
+                    }
+
+                    invalid[word] = bits;
+                }
+            },
+            thread_count, 4096 / word_bits);
+        return invalid;
+    }
+
+private:
+    static constexpr std::size_t word_bits {std::numeric_limits<std::uint64_t>::digits};
+
+    struct Constraint {
+        RawType trigger;
+        RawType group;
+        unsigned min;
+        unsigned max;
+    };
+
+    /**
+     * @brief Append a constraint.
+     *
+     * @exception std::length_error @ref max_constraints constraints have been declared.
+     * In a constant evaluation, it fails the compilation instead.
+     */
+    constexpr FlagConstraints& Add(const Flags trigger, const Flags group, const std::size_t min,
+                                   const std::size_t max) {
+        if (size_ == max_constraints) {
+            throw std::length_error {"Too many flag constraints."};
+        }
+
+        constraints_[size_++] = {trigger, group, static_cast<unsigned>(min),
+                                 static_cast<unsigned>(max)};
+        return *this;
+    }
+
+    std::array<Constraint, max_constraints> constraints_ {};
+    std::size_t size_ {0};
+};
@@ -0,0 +1,119 @@
+/**
+ * @file flag_dispatch.h
+ * @brief Dispatch from runtime @p EnumFlags to template instantiations through a jump table.
+ *
+ * @details
+ * @ref Dispatch instantiates a generic callable for every combination of the flags in a mask,
+ * passing each combination as a @ref StaticFlags whose value is a compile-time constant.
+ * The instantiations are stored in a constant array of function pointers.
+ * At runtime, the flags in the mask are compressed into an array index,
+ * so selecting an instantiation is a single indirect call instead of nested branches.
+ *
+ * @code {.cpp}
+ * Dispatch(options, [&]<typename Static>(const Static) {
+ *     RunKernel<Static::Has(Opt::Checksum), Static::Has(Opt::Compress)>(data);
+ * });
+ * @endcode
+ *
+ * A mask of @p n flags generates <tt>2^n</tt> instantiations,
+ * so it is limited to @ref max_dispatch_flags flags.
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ */
+
+#pragma once
+
+#include "enum_flags.h"
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+//! The maximum number of flags in a dispatch mask.
+inline constexpr std::size_t max_dispatch_flags {8};
+
+//! Flags known at compile time.
+template <typename Enum, typename EnumFlags<Enum>::RawType Value>
+struct StaticFlags {
+    using Flags = EnumFlags<Enum>;
+    using RawType = Flags::RawType;
+
+    static constexpr Flags value {Value};
+
+    //! Check whether a flag is set.
+    static constexpr bool Has(const Enum flag) noexcept {
+        return value.Has(flag);
+    }
+
+    //! Check whether all specific flags are set.
+    static constexpr bool HasAll(const Flags flags) noexcept {
+        return value.HasAll(flags);
+    }
+
+    //! Check whether at least one of the specific flags is set.
+    static constexpr bool HasAny(const Flags flags) noexcept {
+        return value.HasAny(flags);
+    }
+
+    constexpr operator Flags() const noexcept {
+        return value;
+    }
+};
+
+//! Compress the bits of a value selected by a mask into the lowest bits.
+template <std::unsigned_integral RawType>
+constexpr std::size_t CompressBits(const RawType value, RawType mask) noexcept {
+    if ((mask & (mask + 1)) == 0) {
+        // The mask is contiguous from the lowest bit.
+        return value & mask;
+    }
+
+    std::size_t compressed {0};
+    for (std::size_t i {0}; mask != 0; ++i, mask &= mask - 1) {
+        compressed |= static_cast<std::size_t>((value & mask & ~(mask - 1)) != 0) << i;
+    }
+
+    return compressed;
+}
+
+//! Deposit the lowest bits of an index into the bits selected by a mask.
+template <std::unsigned_integral RawType>
+constexpr RawType DepositBits(const std::size_t index, RawType mask) noexcept {
+    RawType value {0};
+    for (std::size_t i {0}; mask != 0; ++i, mask &= mask - 1) {
+        value |= (index >> i & 1) != 0 ? static_cast<RawType>(mask & ~(mask - 1)) : 0;
+    }
+
+    return value;
+}
+
+/**
+ * @brief Call a generic function with flags as a compile-time constant.
+ *
+ * @tparam ValidMask The flags that select an instantiation. Other flags are ignored.
+ * @param flags Runtime flags.
+ * @param func A function called with a @ref StaticFlags holding the flags in @p ValidMask.
+ * All instantiations must return the same type.
+ * @return The result of @p func.
+ */
+template <typename Enum, typename EnumFlags<Enum>::RawType ValidMask = FlagTraits<Enum>::valid_mask,
+          typename Func>
+decltype(auto) Dispatch(const EnumFlags<Enum> flags, Func&& func) {
+    using RawType = EnumFlags<Enum>::RawType;
+    static_assert(static_cast<std::size_t>(std::popcount(ValidMask)) <= max_dispatch_flags,
+                  "A dispatch mask generates an instantiation for each combination of its flags, "
+                  "so it must have at most `max_dispatch_flags` flags.");
+
+    using Result = std::invoke_result_t<Func&, StaticFlags<Enum, 0>>;
+    static constexpr auto table {[]<std::size_t... Indices>(std::index_sequence<Indices...>) {
+        return std::array<Result (*)(Func&), sizeof...(Indices)> {+[](Func& f) -> Result {
+            return std::invoke(f, StaticFlags<Enum, DepositBits(Indices, ValidMask)> {});
+        }...};
+    }(std::make_index_sequence<std::size_t {1} << std::popcount(ValidMask)> {})};
+
+    return table[CompressBits(static_cast<RawType>(flags), ValidMask)](func);
+}
@@ -0,0 +1,352 @@
+/**
+ * @file flag_expressions.h
+ * @brief Lazy expression templates over @p EnumFlags and columns of them.
+ *
+ * @details
+ * @ref Lazy wraps flags or a span of flags into an expression.
+ * Operators on expressions build a tree instead of computing temporaries:
+ *
+ * - @p | for union.
+ * - @p & for intersection. Unlike @p EnumFlags::operator&, it does not return a @p bool.
+ * - @p - for difference.
+ * - @p ^ for symmetric difference.
+ *
+ * A tree over scalar flags is evaluated once when it is converted to @p EnumFlags or tested.
+ * A tree over spans cannot be converted or tested. It drives a single fused pass over all rows,
+ * computing each row with plain integer operations that the compiler can vectorize.
+ *
+ * @code {.cpp}
+ * const EnumFlags<Opt> flags {((Lazy(a) | b) - c) | d};
+ * Evaluate((Lazy(column_a) & Lazy(column_b)) - mask, output);
+ * @endcode
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ */
+
+#pragma once
+
+#include "enum_flags.h"
+#include "parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <ranges>
+#include <span>
+#include <type_traits>
+
+//! Check whether a type is a lazy flag expression.
+template <typename T>
+concept FlagExpression = requires(const T& expr, const std::size_t i) {
+    typename T::Enum;
+    { expr.At(i) } -> std::same_as<typename EnumFlags<typename T::Enum>::RawType>;
+    { expr.Size() } -> std::same_as<std::size_t>;
+    { T::has_columns } -> std::convertible_to<bool>;
+};
+
+//! Check whether a lazy flag expression has at least one column, so it has a finite size.
+template <typename T>
+concept FlagColumnExpression = FlagExpression<T> && T::has_columns;
+
+//! Get the enumeration of an expression operand.
+template <typename T>
+struct FlagOperandEnum {};
+
+template <FlagExpression T>
+struct FlagOperandEnum<T> {
+    using Type = T::Enum;
+};
+
+template <typename Enum>
+struct FlagOperandEnum<EnumFlags<Enum>> {
+    using Type = Enum;
+};
+
+template <typename Enum>
+    requires std::is_scoped_enum_v<Enum>
+struct FlagOperandEnum<Enum> {
+    using Type = Enum;
+};
+
+//! Check whether a range holds @p EnumFlags.
+template <typename Rows>
+concept FlagExpressionRows =
+    requires { typename FlagOperandEnum<std::ranges::range_value_t<Rows>>::Type; }
+    && std::same_as<std::ranges::range_value_t<Rows>,
+                    EnumFlags<typename FlagOperandEnum<std::ranges::range_value_t<Rows>>::Type>>;
+
+//! Flags broadcast to every row of an expression.
+template <typename E>
+class ScalarFlagExpr {
+public:
+    using Enum = E;
+    using Flags = EnumFlags<Enum>;
+    using RawType = Flags::RawType;
+
+    //! A scalar has no column.
+    static constexpr bool has_columns {false};
+
+    explicit constexpr ScalarFlagExpr(const Flags flags) noexcept : flags_ {flags} {}
+
+    constexpr RawType At(std::size_t) const noexcept {
+        return flags_;
+    }
+
+    //! A scalar has no fixed number of rows.
+    constexpr std::size_t Size() const noexcept {
+        return std::dynamic_extent;
+    }
+
+private:
+    RawType flags_;
+};
+
+//! A column of flags, one per row.
+template <typename E>
+class ColumnFlagExpr {
+public:
+    using Enum = E;
+    using Flags = EnumFlags<Enum>;
+    using RawType = Flags::RawType;
+
+    static constexpr bool has_columns {true};
+
+    explicit constexpr ColumnFlagExpr(const std::span<const Flags> rows) noexcept : rows_ {rows} {}
+
+    constexpr RawType At(const std::size_t i) const noexcept {
+        return rows_[i];
+    }
+
+    constexpr std::size_t Size() const noexcept {
+        return rows_.size();
+    }
+
+private:
+    std::span<const Flags> rows_;
+};
+
+struct FlagUnion {
+    template <typename T>
+    static constexpr T Apply(const T lhs, const T rhs) noexcept {
+        return static_cast<T>(lhs | rhs);
+    }
+};
+
+struct FlagIntersection {
+    template <typename T>
+    static constexpr T Apply(const T lhs, const T rhs) noexcept {
+        return static_cast<T>(lhs & rhs);
+    }
+};
+
+struct FlagDifference {
+    template <typename T>
+    static constexpr T Apply(const T lhs, const T rhs) noexcept {
+        return static_cast<T>(lhs & ~rhs);
+    }
+};
+
+struct FlagSymmetricDifference {
+    template <typename T>
+    static constexpr T Apply(const T lhs, const T rhs) noexcept {
+        return static_cast<T>(lhs ^ rhs);
+    }
+};
+
+//! A binary operation on two expressions, holding them by value.
+template <typename Op, FlagExpression Lhs, FlagExpression Rhs>
+    requires std::same_as<typename Lhs::Enum, typename Rhs::Enum>
+class BinaryFlagExpr {
+public:
+    using Enum = Lhs::Enum;
+    using Flags = EnumFlags<Enum>;
+    using RawType = Flags::RawType;
+
+    //! Whether the expression has at least one column, which bounds its number of rows.
+    static constexpr bool has_columns {Lhs::has_columns || Rhs::has_columns};
+
+    constexpr BinaryFlagExpr(const Lhs& lhs, const Rhs& rhs) noexcept : lhs_ {lhs}, rhs_ {rhs} {}
+
+    constexpr RawType At(const std::size_t i) const noexcept {
+        return Op::Apply(lhs_.At(i), rhs_.At(i));
+    }
+
+    //! Get the number of rows, which is the shorter one of two columns.
+    constexpr std::size_t Size() const noexcept {
+        return std::min(lhs_.Size(), rhs_.Size());
+    }
+
+    //! Evaluate an expression over scalar flags. Expressions over columns cannot be converted.
+    constexpr operator Flags() const noexcept
+        requires(!has_columns)
+    {
+        return At(0);
+    }
+
+    //! Check whether a flag is set in the result.
+    constexpr bool Has(const Enum flag) const noexcept
+        requires(!has_columns)
+    {
+        return Flags {At(0)}.Has(flag);
+    }
+
+    //! Check whether all specific flags are set in the result.
+    constexpr bool HasAll(const Flags flags) const noexcept
+        requires(!has_columns)
+    {
+        return Flags {At(0)}.HasAll(flags);
+    }
+
+    //! Check whether at least one of the specific flags is set in the result.
+    constexpr bool HasAny(const Flags flags) const noexcept
+        requires(!has_columns)
+    {
+        return Flags {At(0)}.HasAny(flags);
+    }
+
+    //! Check whether any flags are set in the result.
+    constexpr bool HasAny() const noexcept
+        requires(!has_columns)
+    {
+        return At(0) != 0;
+    }
+
+private:
+    Lhs lhs_;
+    Rhs rhs_;
+};
+
+//! Wrap flags into a lazy expression.
+template <typename Enum>
+constexpr ScalarFlagExpr<Enum> Lazy(const EnumFlags<Enum> flags) noexcept {
+    return ScalarFlagExpr<Enum> {flags};
+}
+
+//! Wrap a flag into a lazy expression.
+template <typename Enum>
+    requires std::is_scoped_enum_v<Enum>
+constexpr ScalarFlagExpr<Enum> Lazy(const Enum flag) noexcept {
+    return ScalarFlagExpr<Enum> {flag};
+}
+
+/**
+ * @brief Wrap a column of flags into a lazy expression.
+ *
+ * @details
+ * The expression refers to the rows, which must outlive it.
+ * Temporary containers are rejected, since they would be destroyed first.
+ */
+template <std::ranges::contiguous_range Rows>
+    requires FlagExpressionRows<Rows> && std::ranges::borrowed_range<Rows>
+constexpr auto Lazy(Rows&& rows) noexcept {
+    using Flags = std::ranges::range_value_t<Rows>;
+    using Enum = FlagOperandEnum<Flags>::Type;
+    return ColumnFlagExpr<Enum> {std::span<const Flags> {rows}};
+}
+
+//! Convert an operand into an expression. Flags and flag values become scalars.
+template <typename Enum, typename T>
+constexpr auto AsFlagExpr(const T& operand) noexcept {
+    if constexpr (FlagExpression<T>) {
+        return operand;
+    } else {
+        return ScalarFlagExpr<Enum> {EnumFlags<Enum> {operand}};
+    }
+}
+
+//! Check whether two operands can be combined lazily. At least one must be an expression.
+template <typename Lhs, typename Rhs>
+concept LazyFlagOperands =
+    (FlagExpression<Lhs> || FlagExpression<Rhs>) && requires {
+        typename FlagOperandEnum<Lhs>::Type;
+        typename FlagOperandEnum<Rhs>::Type;
+    } && std::same_as<typename FlagOperandEnum<Lhs>::Type, typename FlagOperandEnum<Rhs>::Type>;
+
+template <typename Op, typename Lhs, typename Rhs>
+constexpr auto MakeBinaryFlagExpr(const Lhs& lhs, const Rhs& rhs) noexcept {
+    using Enum = FlagOperandEnum<Lhs>::Type;
+    const auto l {AsFlagExpr<Enum>(lhs)};
+    const auto r {AsFlagExpr<Enum>(rhs)};
+    return BinaryFlagExpr<Op, decltype(l), decltype(r)> {l, r};
+}
+
+//! Build the union of two operands.
+template <typename Lhs, typename Rhs>
+    requires LazyFlagOperands<Lhs, Rhs>
+constexpr auto operator|(const Lhs& lhs, const Rhs& rhs) noexcept {
+    return MakeBinaryFlagExpr<FlagUnion>(lhs, rhs);
+}
+
+//! Build the intersection of two operands.
+template <typename Lhs, typename Rhs>
+    requires LazyFlagOperands<Lhs, Rhs>
+constexpr auto operator&(const Lhs& lhs, const Rhs& rhs) noexcept {
+    return MakeBinaryFlagExpr<FlagIntersection>(lhs, rhs);
+}
+
+//! Build the flags of the first operand that are not in the second one.
+template <typename Lhs, typename Rhs>
+    requires LazyFlagOperands<Lhs, Rhs>
+constexpr auto operator-(const Lhs& lhs, const Rhs& rhs) noexcept {
+    return MakeBinaryFlagExpr<FlagDifference>(lhs, rhs);
+}
+
+//! Build the flags in exactly one of two operands.
+template <typename Lhs, typename Rhs>
+    requires LazyFlagOperands<Lhs, Rhs>
+constexpr auto operator^(const Lhs& lhs, const Rhs& rhs) noexcept {
+    return MakeBinaryFlagExpr<FlagSymmetricDifference>(lhs, rhs);
+}
+
+//! Evaluate an expression over scalar flags. Expressions over columns need an output buffer.
+template <FlagExpression Expr>
+    requires(!Expr::has_columns)
+constexpr EnumFlags<typename Expr::Enum> Evaluate(const Expr& expr) noexcept {
+    return expr.At(0);
+}
+
+/**
+ * @brief Evaluate an expression over columns in one fused pass.
+ *
+ * @param expr An expression. A scalar expression is broadcast to every row of @p output.
+ * @param output A buffer for the rows. It may be one of the columns of the expression.
+ * Only the shorter of @p output and <tt>expr.Size()</tt> rows are evaluated.
+ * @param thread_count The maximum number of threads.
+ */
+template <FlagExpression Expr>
+void Evaluate(const Expr& expr, const std::span<EnumFlags<typename Expr::Enum>> output,
+              const std::size_t thread_count = DefaultThreadCount()) {
+    ParallelFor(
+        std::min(expr.Size(), output.size()),
+        [&expr, output](const std::size_t begin, const std::size_t end) noexcept {
+            for (auto i {begin}; i != end; ++i) {
+                output[i] = expr.At(i);
+            }
+        },
+        thread_count);
+}
+
+/**
+ * @brief Count the rows where an expression over columns has at least one flag set.
+ *
+ * @param expr An expression over columns.
+ * @param thread_count The maximum number of threads.
+ */
+template <FlagColumnExpression Expr>
+std::size_t CountAny(const Expr& expr, const std::size_t thread_count = DefaultThreadCount()) {
+    std::atomic_size_t count {0};
+    ParallelFor(
+        expr.Size(),
+        [&expr, &count](const std::size_t begin, const std::size_t end) noexcept {
+            std::size_t part {0};
+            for (auto i {begin}; i != end; ++i) {
+                part += expr.At(i) != 0 ? 1 : 0;
+            }
+
+            count.fetch_add(part, std::memory_order_relaxed);
+        },
+        thread_count);
+    return count.load(std::memory_order_relaxed);
+}
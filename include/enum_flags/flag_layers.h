@@ -0,0 +1,275 @@
+/**
+ * @file flag_layers.h
+ * @brief Layered @p EnumFlags resolved from tri-state overrides with cached results.
+ *
+ * @details
+ * A @ref FlagOverride sets, clears or leaves each flag unspecified.
+ * It is a pair of masks applied to base flags with two operations,
+ * and consecutive overrides compose into a single override.
+ *
+ * @ref FlagLayerChain resolves defaults through a chain of @ref FlagLayer objects,
+ * such as tenant settings and user overrides.
+ * Every layer has a version incremented when its override changes.
+ * The chain caches the flags resolved after each layer,
+ * and only recomputes from the first layer whose version has changed since the last resolution.
+ * Per-request options are applied to the cached result without touching the cache.
+ *
+ * @code {.cpp}
+ * FlagLayer<Opt> tenant, user;
+ * FlagLayerChain<Opt> chain {{Opt::Gzip, Opt::Log}, {&tenant, &user}};
+ * tenant.Clear(Opt::Log);
+ * user.Set(Opt::Trace);
+ * const auto flags {chain.Resolve(FlagOverride<Opt> {}.Clear(Opt::Gzip))};
+ * @endcode
+ *
+ * Layers and chains are not thread-safe.
+ * Resolving updates the cache of a chain, so each thread needs its own chain.
+ * Layers are read without synchronization while resolving,
+ * so changing a layer while the system is running needs external locking:
+ * the same mutex must guard every change of a layer and every @p Resolve through it.
+ *
+ * @code {.cpp}
+ * std::shared_mutex mutex;
+ *
+ * // A thread changing runtime overrides.
+ * {
+ *     const std::unique_lock lock {mutex};
+ *     tenant.Set(Opt::Trace);
+ * }
+ *
+ * // A thread handling requests, with its own chain.
+ * const auto flags {[&] {
+ *     const std::shared_lock lock {mutex};
+ *     return chain.Resolve(request);
+ * }()};
+ * @endcode
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ */
+
+#pragma once
+
+#include "enum_flags.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <span>
+#include <vector>
+
+//! Flags to set or clear, leaving other flags unspecified.
+template <typename Enum>
+class FlagOverride {
+public:
+    using Flags = EnumFlags<Enum>;
+    using RawType = Flags::RawType;
+
+    constexpr FlagOverride() noexcept = default;
+
+    //! Get the flags to set.
+    constexpr Flags Sets() const noexcept {
+        return set_;
+    }
+
+    //! Get the flags to clear.
+    constexpr Flags Clears() const noexcept {
+        return clear_;
+    }
+
+    //! Get the flags that are set or cleared.
+    constexpr Flags Specified() const noexcept {
+        return static_cast<RawType>(set_ | clear_);
+    }
+
+    //! Set specific flags, replacing earlier specifications of them.
+    constexpr FlagOverride& Set(const Flags flags) noexcept {
+        const auto raw {static_cast<RawType>(flags)};
+        set_ = static_cast<RawType>(set_ | raw);
+        clear_ = static_cast<RawType>(clear_ & ~raw);
+        return *this;
+    }
+
+    //! Clear specific flags, replacing earlier specifications of them.
+    constexpr FlagOverride& Clear(const Flags flags) noexcept {
+        const auto raw {static_cast<RawType>(flags)};
+        clear_ = static_cast<RawType>(clear_ | raw);
+        set_ = static_cast<RawType>(set_ & ~raw);
+        return *this;
+    }
+
+    //! Leave specific flags unspecified.
+    constexpr FlagOverride& Unset(const Flags flags) noexcept {
+        const auto raw {static_cast<RawType>(flags)};
+        set_ = static_cast<RawType>(set_ & ~raw);
+        clear_ = static_cast<RawType>(clear_ & ~raw);
+        return *this;
+    }
+
+    //! Apply the override to base flags.
+    constexpr Flags Apply(const Flags base) const noexcept {
+        return static_cast<RawType>((static_cast<RawType>(base) & ~clear_) | set_);
+    }
+
+    /**
+     * @brief Compose the override with a later one.
+     *
+     * @return An override equivalent to applying this override and then @p next.
+     */
+    constexpr FlagOverride Then(const FlagOverride& next) const noexcept {
+        FlagOverride composed;
+        composed.set_ = static_cast<RawType>((set_ & ~next.clear_) | next.set_);
+        composed.clear_ = static_cast<RawType>((clear_ & ~next.set_) | next.clear_);
+        return composed;
+    }
+
+    constexpr bool operator==(const FlagOverride&) const noexcept = default;
+
+private:
+    RawType set_ {0};
+    RawType clear_ {0};
+};
+
+/**
+ * @brief A layer of flag overrides with a version incremented on every change.
+ *
+ * @details
+ * Changes are not synchronized with chains resolving through the layer.
+ */
+template <typename Enum>
+class FlagLayer {
+public:
+    using Flags = EnumFlags<Enum>;
+    using Override = FlagOverride<Enum>;
+
+    explicit FlagLayer(const Override& override = {}) noexcept : override_ {override} {}
+
+    FlagLayer(const FlagLayer&) = delete;
+
+    FlagLayer& operator=(const FlagLayer&) = delete;
+
+    //! Get the override.
+    const Override& Load() const noexcept {
+        return override_;
+    }
+
+    //! Get the version, which changes whenever the override changes.
+    std::uint64_t Version() const noexcept {
+        return version_;
+    }
+
+    //! Set specific flags.
+    void Set(const Flags flags) noexcept {
+        Store(Override {override_}.Set(flags));
+    }
+
+    //! Clear specific flags.
+    void Clear(const Flags flags) noexcept {
+        Store(Override {override_}.Clear(flags));
+    }
+
+    //! Leave specific flags unspecified.
+    void Unset(const Flags flags) noexcept {
+        Store(Override {override_}.Unset(flags));
+    }
+
+    //! Replace the override.
+    void Store(const Override& override) noexcept {
+        if (override != override_) {
+            override_ = override;
+            ++version_;
+        }
+    }
+
+private:
+    Override override_;
+    std::uint64_t version_ {0};
+};
+
+/**
+ * @brief Defaults resolved through a chain of layers, caching the result after each layer.
+ *
+ * @details
+ * Resolving may update the cache, so a chain must not be shared between threads.
+ */
+template <typename Enum>
+class FlagLayerChain {
+public:
+    using Flags = EnumFlags<Enum>;
+    using Override = FlagOverride<Enum>;
+    using Layer = FlagLayer<Enum>;
+
+    /**
+     * @brief Create a chain.
+     *
+     * @param defaults Flags before any layer.
+     * @param layers Layers from the lowest to the highest priority, which must outlive the chain.
+     */
+    FlagLayerChain(const Flags defaults, const std::span<const Layer* const> layers) :
+        defaults_ {defaults} {
+        cache_.reserve(layers.size());
+        for (const auto* const layer : layers) {
+            cache_.push_back({layer, 0, defaults});
+        }
+
+        Refresh(0);
+    }
+
+    FlagLayerChain(const Flags defaults, const std::initializer_list<const Layer*> layers) :
+        FlagLayerChain {defaults, std::span {layers.begin(), layers.size()}} {}
+
+    /**
+     * @brief Get the flags resolved through all layers.
+     *
+     * @details
+     * No layer may change during the call. If layers change at runtime, hold a shared lock.
+     */
+    Flags Resolve() noexcept {
+        for (std::size_t i {0}; i != cache_.size(); ++i) {
+            if (cache_[i].version != cache_[i].layer->Version()) {
+                Refresh(i);
+                break;
+            }
+        }
+
+        return cache_.empty() ? defaults_ : cache_.back().flags;
+    }
+
+    //! Get the flags resolved through all layers and then a per-request override.
+    Flags Resolve(const Override& request) noexcept {
+        return request.Apply(Resolve());
+    }
+
+    //! Get the number of times a layer has been applied, including when the chain was created.
+    std::size_t Recomputations() const noexcept {
+        return recomputations_;
+    }
+
+private:
+    struct CachedLayer {
+        const Layer* layer;
+
+        //! The version of the layer when it was applied.
+        std::uint64_t version;
+
+        //! The flags resolved after the layer.
+        Flags flags;
+    };
+
+    //! Recompute the cached flags from a layer onwards.
+    void Refresh(const std::size_t first) noexcept {
+        auto flags {first == 0 ? defaults_ : cache_[first - 1].flags};
+        for (auto i {first}; i != cache_.size(); ++i) {
+            auto& cached {cache_[i]};
+            cached.version = cached.layer->Version();
+            flags = cached.layer->Load().Apply(flags);
+            cached.flags = flags;
+        }
+
+        recomputations_ += cache_.size() - first;
+    }
+
+    Flags defaults_;
+    std::vector<CachedLayer> cache_;
+    std::size_t recomputations_ {0};
+};
@@ -0,0 +1,207 @@
+/**
+ * @file flag_partition.h
+ * @brief Branch-free stream compaction and partitioning of records by a flag predicate.
+ *
+ * @details
+ * A projection gets the flags of a record and a predicate tests them,
+ * for example a @ref FlagQuery.
+ * The kernels never branch on the predicate.
+ * Each row is written unconditionally and the output cursor advances by the result,
+ * so the cost does not depend on how predictable the selection is.
+ *
+ * - @ref CompactIndices writes the indices of matching rows in order.
+ * - @ref PartitionBy moves matching records to the front in place, without preserving order.
+ * - @ref StablePartitionBy preserves order and runs in parallel.
+ *   Rows are split into blocks whose matches are counted first.
+ *   The prefix sums of the counts give every block its own output ranges,
+ *   so blocks are then scattered independently.
+ *
+ * @code {.cpp}
+ * const auto selected {PartitionBy(std::span {records}, &Record::flags,
+ *                                  FlagQuery<Opt> {Opt::Active, Opt::Deleted})};
+ * @endcode
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ */
+
+#pragma once
+
+#include "flag_queries.h"
+#include "parallel.h"
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <numeric>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+//! Check whether a predicate can test the projected flags of a record.
+template <typename Pred, typename Proj, typename Record>
+concept FlagRecordPredicate =
+    std::regular_invocable<Proj, const Record&>
+    && std::predicate<const Pred&, std::invoke_result_t<Proj, const Record&>>;
+
+/**
+ * @brief Write the indices of matching records in order.
+ *
+ * @param records Records.
+ * @param proj A projection getting the flags of a record.
+ * @param pred A predicate on the flags.
+ * @param indices A buffer of at least <tt>records.size()</tt> indices.
+ * @return The number of matching records, whose indices are at the beginning of @p indices.
+ */
+template <typename Record, typename Proj, typename Pred>
+    requires FlagRecordPredicate<Pred, Proj, Record>
+std::size_t CompactIndices(const std::span<const Record> records, Proj proj, const Pred& pred,
+                           const std::span<std::size_t> indices) noexcept {
+    std::size_t count {0};
+    for (std::size_t i {0}; i != records.size(); ++i) {
+        indices[count] = i;
+        count += static_cast<std::size_t>(
+            static_cast<bool>(std::invoke(pred, std::invoke(proj, records[i]))));
+    }
+
+    return count;
+}
+
+//! The number of rows per block of the parallel partition kernels.
+inline constexpr std::size_t partition_block_rows {4096};
+
+/**
+ * @brief Count the matching records of each block.
+ *
+ * @return The exclusive prefix sums of the counts, followed by the total.
+ */
+template <typename Record, typename Proj, typename Pred>
+std::vector<std::size_t> PartitionBlockOffsets(const std::span<const Record> records, Proj& proj,
+                                               const Pred& pred, const std::size_t thread_count) {
+    const auto block_count {(records.size() + partition_block_rows - 1) / partition_block_rows};
+    std::vector<std::size_t> offsets(block_count + 1);
+    ParallelFor(
+        block_count,
+        [records, &proj, &pred, &offsets](const std::size_t begin, const std::size_t end) {
+            for (auto block {begin}; block != end; ++block) {
+                const auto rows {records.subspan(block * partition_block_rows)};
+                std::size_t count {0};
+                for (std::size_t i {0}; i != std::min(partition_block_rows, rows.size()); ++i) {
+                    count += static_cast<std::size_t>(
+                        static_cast<bool>(std::invoke(pred, std::invoke(proj, rows[i]))));
+                }
+
+                offsets[block + 1] = count;
+            }
+        },
+        thread_count, 1);
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    return offsets;
+}
+
+/**
+ * @brief Get the indices of matching records in order, in parallel.
+ *
+ * @param records Records.
+ * @param proj A projection getting the flags of a record.
+ * @param pred A predicate on the flags.
+ * @param thread_count The maximum number of threads.
+ */
+template <typename Record, typename Proj, typename Pred>
+    requires FlagRecordPredicate<Pred, Proj, Record>
+std::vector<std::size_t> CompactIndices(const std::span<const Record> records, Proj proj,
+                                        const Pred& pred,
+                                        const std::size_t thread_count = DefaultThreadCount()) {
+    const auto offsets {PartitionBlockOffsets(records, proj, pred, thread_count)};
+    std::vector<std::size_t> indices(offsets.back());
+    ParallelFor(
+        offsets.size() - 1,
+        [records, &proj, &pred, &offsets, &indices](const std::size_t begin,
+                                                    const std::size_t end) {
+            for (auto block {begin}; block != end; ++block) {
+                const auto first {block * partition_block_rows};
+                const auto last {std::min(first + partition_block_rows, records.size())};
+                auto count {offsets[block]};
+                // The slot after the last match of a block belongs to the next block,
+                // so a mismatch is written to a local sink instead.
+                std::size_t sink;
+                for (auto i {first}; i != last; ++i) {
+                    const bool matched {std::invoke(pred, std::invoke(proj, records[i]))};
+                    *(matched ? indices.data() + count : &sink) = i;
+                    count += static_cast<std::size_t>(matched);
+                }
+            }
+        },
+        thread_count, 1);
+    return indices;
+}
+
+/**
+ * @brief Move matching records to the front, without preserving order.
+ *
+ * @details
+ * It is a Lomuto partition whose swap is unconditional.
+ *
+ * @return The number of matching records.
+ */
+template <typename Record, typename Proj, typename Pred>
+    requires std::swappable<Record> && FlagRecordPredicate<Pred, Proj, Record>
+std::size_t PartitionBy(const std::span<Record> records, Proj proj, const Pred& pred) {
+    std::size_t count {0};
+    for (std::size_t i {0}; i != records.size(); ++i) {
+        const bool matched {std::invoke(pred, std::invoke(proj, std::as_const(records[i])))};
+        std::ranges::swap(records[count], records[i]);
+        count += static_cast<std::size_t>(matched);
+    }
+
+    return count;
+}
+
+/**
+ * @brief Move matching records to the front, preserving the order of both groups.
+ *
+ * @param records Records.
+ * @param proj A projection getting the flags of a record.
+ * @param pred A predicate on the flags.
+ * @param thread_count The maximum number of threads.
+ * @return The number of matching records.
+ */
+template <typename Record, typename Proj, typename Pred>
+    requires std::copyable<Record> && FlagRecordPredicate<Pred, Proj, Record>
+std::size_t StablePartitionBy(const std::span<Record> records, Proj proj, const Pred& pred,
+                              const std::size_t thread_count = DefaultThreadCount()) {
+    const std::span<const Record> rows {records};
+    const auto offsets {PartitionBlockOffsets(rows, proj, pred, thread_count)};
+    const auto matched_count {offsets.back()};
+    std::vector<Record> output(rows.begin(), rows.end());
+    ParallelFor(
+        offsets.size() - 1,
+        [rows, matched_count, &proj, &pred, &offsets, &output](const std::size_t begin,
+                                                               const std::size_t end) {
+            for (auto block {begin}; block != end; ++block) {
+                const auto first {block * partition_block_rows};
+                const auto last {std::min(first + partition_block_rows, rows.size())};
+                // Matching records go after the matches of earlier blocks,
+                // others after all matches and the others of earlier blocks.
+                std::array<std::size_t, 2> cursors {matched_count + first - offsets[block],
+                                                    offsets[block]};
+                for (auto i {first}; i != last; ++i) {
+                    const bool matched {std::invoke(pred, std::invoke(proj, rows[i]))};
+                    output[cursors[matched]++] = rows[i];
+                }
+            }
+        },
+        thread_count, 1);
+
+    ParallelFor(
+        records.size(),
+        [records, &output](const std::size_t begin, const std::size_t end) {
+            std::ranges::move(output.begin() + begin, output.begin() + end,
+                              records.begin() + begin);
+        },
+        thread_count);
+    return matched_count;
+}
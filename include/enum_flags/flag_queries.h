@@ -0,0 +1,187 @@
+/**
+ * @file flag_queries.h
+ * @brief Many flag predicates evaluated over rows of @p EnumFlags in one pass.
+ *
+ * @details
+ * A query requires some flags to be set and others to be cleared,
+ * which covers @p HasAll, negated @p HasAny and their combinations.
+ *
+ * @ref FlagQueryBatch stores the masks of all queries in contiguous arrays.
+ * Rows are scanned in blocks of 64, and every query is evaluated against a block
+ * while it is still in the L1 cache, so the column is read from memory only once.
+ * Each query over a block is a branch-free loop producing one word of a selection bitmap.
+ *
+ * @code {.cpp}
+ * const FlagQueryBatch<Opt> queries {{{Opt::A, Opt::B}, {}}, {Opt::A, Opt::C}};
+ * const auto counts {queries.Count(rows)};
+ * @endcode
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ */
+
+#pragma once
+
+#include "enum_flags.h"
+#include "parallel.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+#include <span>
+#include <vector>
+
+//! A predicate requiring some flags to be set and others to be cleared.
+template <typename Enum>
+struct FlagQuery {
+    //! Flags that must all be set.
+    EnumFlags<Enum> required;
+
+    //! Flags that must all be cleared.
+    EnumFlags<Enum> forbidden;
+
+    //! Check whether flags satisfy the query.
+    constexpr bool Matches(const EnumFlags<Enum> flags) const noexcept {
+        return flags.HasAll(required) && !flags.HasAny(forbidden);
+    }
+
+    //! Use the query as a predicate.
+    constexpr bool operator()(const EnumFlags<Enum> flags) const noexcept {
+        return Matches(flags);
+    }
+};
+
+//! A batch of queries evaluated together in one pass over rows.
+template <typename Enum>
+class FlagQueryBatch {
+public:
+    using Flags = EnumFlags<Enum>;
+    using RawType = Flags::RawType;
+    using Query = FlagQuery<Enum>;
+
+    //! The number of rows per word of a selection bitmap.
+    static constexpr std::size_t word_bits {std::numeric_limits<std::uint64_t>::digits};
+
+    explicit FlagQueryBatch(const std::span<const Query> queries) {
+        required_.reserve(queries.size());
+        forbidden_.reserve(queries.size());
+        for (const auto& [required, forbidden] : queries) {
+            required_.push_back(static_cast<RawType>(required));
+            forbidden_.push_back(static_cast<RawType>(forbidden));
+        }
+    }
+
+    FlagQueryBatch(const std::initializer_list<Query> queries) :
+        FlagQueryBatch {std::span {queries.begin(), queries.size()}} {}
+
+    //! Get the number of queries.
+    std::size_t Size() const noexcept {
+        return required_.size();
+    }
+
+    //! Get the number of bitmap words per query for a number of rows.
+    static constexpr std::size_t WordCount(const std::size_t row_count) noexcept {
+        return (row_count + word_bits - 1) / word_bits;
+    }
+
+    /**
+     * @brief Evaluate all queries over rows.
+     *
+     * @param rows Rows of flags.
+     * @param thread_count The maximum number of threads.
+     * @return A bitmap of <tt>Size() * WordCount(rows.size())</tt> words.
+     * Row @p i is selected by query @p q if bit <tt>i % 64</tt> of word
+     * <tt>q * WordCount(rows.size()) + i / 64</tt> is set.
+     */
+    std::vector<std::uint64_t> Select(const std::span<const Flags> rows,
+                                      const std::size_t thread_count = DefaultThreadCount()) const {
+        const auto word_count {WordCount(rows.size())};
+        std::vector<std::uint64_t> selection(Size() * word_count);
+        ParallelFor(
+            word_count,
+            [this, rows, word_count, &selection](const std::size_t begin, const std::size_t end) {
+                std::array<RawType, word_bits> block;
+                for (auto word {begin}; word != end; ++word) {
+                    const auto size {Load(rows, word, block)};
+                    for (std::size_t q {0}; q != Size(); ++q) {
+                        selection[q * word_count + word] = Match(q, block, size);
+                    }
+                }
+            },
+            thread_count, 4096 / word_bits);
+        return selection;
+    }
+
+    /**
+     * @brief Count the rows selected by each query.
+     *
+     * @param rows Rows of flags.
+     * @param thread_count The maximum number of threads.
+     * @return The number of selected rows for each query.
+     */
+    std::vector<std::size_t> Count(const std::span<const Flags> rows,
+                                   const std::size_t thread_count = DefaultThreadCount()) const {
+        std::vector<std::atomic_size_t> totals(Size());
+        ParallelFor(
+            WordCount(rows.size()),
+            [this, rows, &totals](const std::size_t begin, const std::size_t end) {
+                std::vector<std::size_t> counts(Size());
+                std::array<RawType, word_bits> block;
+                for (auto word {begin}; word != end; ++word) {
+                    const auto size {Load(rows, word, block)};
+                    for (std::size_t q {0}; q != Size(); ++q) {
+                        counts[q] += static_cast<std::size_t>(std::popcount(Match(q, block, size)));
+                    }
+                }
+
+                for (std::size_t q {0}; q != Size(); ++q) {
+                    totals[q].fetch_add(counts[q], std::memory_order_relaxed);
+                }
+            },
+            thread_count, 4096 / word_bits);
+
+        std::vector<std::size_t> counts;
+        counts.reserve(Size());
+        for (const auto& total : totals) {
+            counts.push_back(total.load(std::memory_order_relaxed));
+        }
+
+        return counts;
+    }
+
+private:
+    //! Copy a block of rows as raw values and get its size.
+    static std::size_t Load(const std::span<const Flags> rows, const std::size_t word,
+                            std::array<RawType, word_bits>& block) noexcept {
+        const auto begin {word * word_bits};
+        const auto size {std::min(word_bits, rows.size() - begin)};
+        for (std::size_t i {0}; i != size; ++i) {
+            block[i] = static_cast<RawType>(rows[begin + i]);
+        }
+
+        return size;
+    }
+
+    //! Evaluate a query over a block of rows.
+    std::uint64_t Match(const std::size_t q, const std::array<RawType, word_bits>& block,
+                        const std::size_t size) const noexcept {
+        const auto required {required_[q]};
+        const auto forbidden {forbidden_[q]};
+        std::uint64_t bits {0};
+        for (std::size_t i {0}; i != size; ++i) {
+            const auto row {block[i]};
+            const auto matched {((row & required) == required) & ((row & forbidden) == 0)};
+            bits |= static_cast<std::uint64_t>(matched) << i;
+        }
+
+        return bits;
+    }
+
+    std::vector<RawType> required_;
+    std::vector<RawType> forbidden_;
+};
@@ -0,0 +1,260 @@
+/**
+ * @file flag_stream.h
+ * @brief Chunked streaming reader and writer for columns of @p EnumFlags.
+ *
+ * @details
+ * Records are stored as raw underlying values in native byte order.
+ * A reader or writer owns two fixed-size chunks and a background I/O thread,
+ * so that the I/O of one chunk overlaps with the processing of the other.
+ * Chunks are allocated once on construction and reused afterwards.
+ * When both chunks are busy, the faster side blocks until the slower one catches up.
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ */
+
+#pragma once
+
+#include "enum_flags.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <span>
+#include <thread>
+#include <vector>
+
+//! A double-buffered reader producing chunks of @p EnumFlags from a binary input stream.
+template <typename Enum>
+class FlagStreamReader {
+public:
+    using Flags = EnumFlags<Enum>;
+
+    static_assert(std::is_trivially_copyable_v<Flags>
+                  && sizeof(Flags) == sizeof(typename Flags::RawType));
+
+    /**
+     * @brief Start reading from a stream in the background.
+     *
+     * @param in An input stream opened in binary mode. It must outlive the reader.
+     * @param chunk_size The maximum number of records in a chunk.
+     */
+    FlagStreamReader(std::istream& in, const std::size_t chunk_size) :
+        in_ {in},
+        chunks_ {Chunk {std::max<std::size_t>(chunk_size, 1)},
+                 Chunk {std::max<std::size_t>(chunk_size, 1)}},
+        io_ {[this] { Produce(); }} {}
+
+    FlagStreamReader(const FlagStreamReader&) = delete;
+
+    FlagStreamReader& operator=(const FlagStreamReader&) = delete;
+
+    //! Stop reading and wait for the I/O thread.
+    ~FlagStreamReader() {
+        for (auto& chunk : chunks_) {
+            chunk.state.store(ChunkState::Stopped, std::memory_order_release);
+            chunk.state.notify_all();
+        }
+
+        io_.join();
+    }
+
+    /**
+     * @brief Get the next chunk of records.
+     *
+     * @details
+     * The previously returned chunk is released for reuse, so its span must not be used anymore.
+     *
+     * @return A span over an internal buffer, or an empty span at the end of the stream.
+     */
+    std::span<const Flags> Next() noexcept {
+        if (holding_) {
+            auto& prev {chunks_[curr_]};
+            prev.state.store(ChunkState::Free, std::memory_order_release);
+            prev.state.notify_all();
+            holding_ = false;
+            curr_ ^= 1;
+        }
+
+        const auto& chunk {chunks_[curr_]};
+        chunk.state.wait(ChunkState::Free, std::memory_order_acquire);
+        if (chunk.size == 0) {
+            return {};
+        }
+
+        holding_ = true;
+        return {chunk.records.data(), chunk.size};
+    }
+
+    //! Check whether the stream ended with an incomplete record, which has been discarded.
+    bool Truncated() const noexcept {
+        return truncated_.load(std::memory_order_acquire);
+    }
+
+private:
+    enum class ChunkState : std::uint8_t { Free, Filled, Stopped };
+
+    struct Chunk {
+        explicit Chunk(const std::size_t capacity) : records(capacity) {}
+
+        std::vector<Flags> records;
+        std::size_t size {0};
+        std::atomic<ChunkState> state {ChunkState::Free};
+    };
+
+    void Produce() {
+        for (std::size_t i {0};; i ^= 1) {
+            auto& chunk {chunks_[i]};
+            chunk.state.wait(ChunkState::Filled, std::memory_order_acquire);
+            if (chunk.state.load(std::memory_order_acquire) == ChunkState::Stopped) {
+                return;
+            }
+
+            in_.read(reinterpret_cast<char*>(chunk.records.data()),
+                     static_cast<std::streamsize>(chunk.records.size() * sizeof(Flags)));
+            const auto bytes {static_cast<std::size_t>(in_.gcount())};
+            if (bytes % sizeof(Flags) != 0) {
+                truncated_.store(true, std::memory_order_release);
+            }
+
+            chunk.size = bytes / sizeof(Flags);
+            auto expected {ChunkState::Free};
+            if (!chunk.state.compare_exchange_strong(expected, ChunkState::Filled,
+                                                     std::memory_order_acq_rel)) {
+                return;
+            }
+
+            chunk.state.notify_all();
+            if (chunk.size == 0) {
+                return;
+            }
+        }
+    }
+
+    std::istream& in_;
+    std::array<Chunk, 2> chunks_;
+    std::size_t curr_ {0};
+    bool holding_ {false};
+    std::atomic_bool truncated_ {false};
+    std::thread io_;
+};
+
+//! A double-buffered writer sending chunks of @p EnumFlags to a binary output stream.
+template <typename Enum>
+class FlagStreamWriter {
+public:
+    using Flags = EnumFlags<Enum>;
+
+    static_assert(std::is_trivially_copyable_v<Flags>
+                  && sizeof(Flags) == sizeof(typename Flags::RawType));
+
+    /**
+     * @brief Start writing to a stream in the background.
+     *
+     * @param out An output stream opened in binary mode. It must outlive the writer.
+     * @param chunk_size The number of records buffered before a chunk is sent to the stream.
+     */
+    FlagStreamWriter(std::ostream& out, const std::size_t chunk_size) :
+        out_ {out},
+        chunks_ {Chunk {std::max<std::size_t>(chunk_size, 1)},
+                 Chunk {std::max<std::size_t>(chunk_size, 1)}},
+        io_ {[this] { Consume(); }} {}
+
+    FlagStreamWriter(const FlagStreamWriter&) = delete;
+
+    FlagStreamWriter& operator=(const FlagStreamWriter&) = delete;
+
+    //! Write all buffered records, then stop the I/O thread.
+    ~FlagStreamWriter() {
+        Flush();
+        for (auto& chunk : chunks_) {
+            chunk.state.store(ChunkState::Stopped, std::memory_order_release);
+            chunk.state.notify_all();
+        }
+
+        io_.join();
+    }
+
+    //! Buffer a record.
+    void Write(const Flags flags) noexcept {
+        Write(std::span {&flags, 1});
+    }
+
+    /**
+     * @brief Buffer records.
+     *
+     * @details
+     * A full chunk is handed to the I/O thread.
+     * If the I/O thread is still writing the other chunk, it blocks until that chunk is free.
+     */
+    void Write(std::span<const Flags> flags) noexcept {
+        while (!flags.empty()) {
+            auto& chunk {chunks_[curr_]};
+            const auto count {std::min(flags.size(), chunk.records.size() - chunk.size)};
+            std::ranges::copy(flags.first(count), chunk.records.begin() + chunk.size);
+            chunk.size += count;
+            flags = flags.subspan(count);
+            if (chunk.size == chunk.records.size()) {
+                Submit();
+            }
+        }
+    }
+
+    //! Send all buffered records to the stream and wait until they are written.
+    void Flush() {
+        if (chunks_[curr_].size != 0) {
+            Submit();
+        }
+
+        for (const auto& chunk : chunks_) {
+            chunk.state.wait(ChunkState::Pending, std::memory_order_acquire);
+        }
+
+        out_.flush();
+    }
+
+private:
+    enum class ChunkState : std::uint8_t { Free, Pending, Stopped };
+
+    struct Chunk {
+        explicit Chunk(const std::size_t capacity) : records(capacity) {}
+
+        std::vector<Flags> records;
+        std::size_t size {0};
+        std::atomic<ChunkState> state {ChunkState::Free};
+    };
+
+    //! Hand the current chunk to the I/O thread and wait for the other one to become free.
+    void Submit() noexcept {
+        auto& chunk {chunks_[curr_]};
+        chunk.state.store(ChunkState::Pending, std::memory_order_release);
+        chunk.state.notify_all();
+        curr_ ^= 1;
+        chunks_[curr_].state.wait(ChunkState::Pending, std::memory_order_acquire);
+    }
+
+    void Consume() {
+        for (std::size_t i {0};; i ^= 1) {
+            auto& chunk {chunks_[i]};
+            chunk.state.wait(ChunkState::Free, std::memory_order_acquire);
+            if (chunk.state.load(std::memory_order_acquire) == ChunkState::Stopped) {
+                return;
+            }
+
+            out_.write(reinterpret_cast<const char*>(chunk.records.data()),
+                       static_cast<std::streamsize>(chunk.size * sizeof(Flags)));
+            chunk.size = 0;
+            chunk.state.store(ChunkState::Free, std::memory_order_release);
+            chunk.state.notify_all();
+        }
+    }
+
+    std::ostream& out_;
+    std::array<Chunk, 2> chunks_;
+    std::size_t curr_ {0};
+    std::thread io_;
+};
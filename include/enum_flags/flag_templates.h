@@ -0,0 +1,96 @@
+/**
+ * @file flag_templates.h
+ * @brief Compile-time helpers for @p EnumFlags used as non-type template parameters.
+ *
+ * @details
+ * @p EnumFlags is a structural type, so a flag set can select a specialization:
+ *
+ * @code {.cpp}
+ * template <EnumFlags<Stage> Stages>
+ * void RunPipeline(Data& data) {
+ *     if constexpr (HasFlag_v<Stages, Stage::Decode>) {
+ *         Decode(data);
+ *     }
+ *
+ *     ToFlagList_t<Stages>::ForEach([&](const auto stage) { Run<stage()>(data); });
+ * }
+ *
+ * RunPipeline<EnumFlags<Stage> {Stage::Decode, Stage::Verify}>(data);
+ * @endcode
+ *
+ * Every helper is evaluated at compile time and adds no runtime cost.
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ */
+
+#pragma once
+
+#include "enum_flags.h"
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+//! Check at compile time whether a flag is set in flags.
+template <auto Flags, auto Flag>
+    requires std::same_as<std::remove_cv_t<decltype(Flags)>, EnumFlags<decltype(Flag)>>
+inline constexpr bool HasFlag_v {Flags.Has(Flag)};
+
+//! A list of flags as a type.
+template <typename Enum, Enum... Flags>
+struct FlagList {
+    using Type = Enum;
+
+    //! The number of flags in the list.
+    static constexpr std::size_t size {sizeof...(Flags)};
+
+    //! The union of the flags in the list.
+    static constexpr EnumFlags<Enum> flags {
+        static_cast<EnumFlags<Enum>::RawType>((typename EnumFlags<Enum>::RawType {0} | ...
+                                               | std::to_underlying(Flags)))};
+
+    //! Call a function with each flag as a @p std::integral_constant, in list order.
+    template <typename Func>
+    static constexpr void ForEach(Func&& func) {
+        (func(std::integral_constant<Enum, Flags> {}), ...);
+    }
+};
+
+//! Get the union of the flags in a @ref FlagList.
+template <typename List>
+inline constexpr auto FlagListFlags_v {List::flags};
+
+//! Get the enumeration of an @p EnumFlags type.
+template <typename Flags>
+struct FlagsEnum {};
+
+template <typename Enum>
+struct FlagsEnum<EnumFlags<Enum>> {
+    using Type = Enum;
+};
+
+//! Convert flags to a @ref FlagList of their set flags, from the lowest bit to the highest.
+template <auto Flags, typename Indices = std::make_index_sequence<Flags.Count()>>
+struct ToFlagList;
+
+template <auto Flags, std::size_t... Indices>
+struct ToFlagList<Flags, std::index_sequence<Indices...>> {
+private:
+    using Enum = FlagsEnum<std::remove_cv_t<decltype(Flags)>>::Type;
+
+    static constexpr std::array<Enum, sizeof...(Indices)> flag_array {[] {
+        std::array<Enum, sizeof...(Indices)> array {};
+        std::size_t i {0};
+        Flags.ForEach([&array, &i](const Enum flag) noexcept { array[i++] = flag; });
+        return array;
+    }()};
+
+public:
+    using Type = FlagList<Enum, flag_array[Indices]...>;
+};
+
+template <auto Flags>
+using ToFlagList_t = ToFlagList<Flags>::Type;
@@ -0,0 +1,174 @@
+/**
+ * @file flag_transpose.h
+ * @brief Bit-matrix transposition between rows of @p EnumFlags and per-flag bitmaps.
+ *
+ * @details
+ * Rows of flags form a bit matrix with one row per record and one column per flag.
+ * Its transpose has one bitmap per flag over all rows,
+ * which is the layout for counting or combining a flag column by column.
+ *
+ * Rows are transposed in blocks of 64, each producing one word of every bitmap:
+ *
+ * - Flags of at most 8 bits are packed eight rows to a word
+ *   and transposed as 8 × 8 matrices with three delta swaps.
+ * - Wider flags are zero-extended and transposed as a 64 × 64 matrix
+ *   with six rounds of masked swaps over half, quarter, ..., single-bit sub-blocks.
+ *
+ * Both kernels only use shifts, masks and XORs on whole words,
+ * and blocks are processed in parallel.
+ *
+ * Bitmaps are stored flag-major.
+ * Bit @p i of flag @p b is bit <tt>i % 64</tt> of word <tt>b * word_count + i / 64</tt>,
+ * where @p word_count is @ref BitmapWordCount of the number of rows.
+ * Bits of a bitmap beyond the last row are cleared,
+ * and bits of a row at or above <tt>FlagTraits<Enum>::bit_width</tt> are dropped.
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ */
+
+#pragma once
+
+#include "enum_flags.h"
+#include "parallel.h"
+
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+//! Transpose an 8 × 8 bit matrix whose byte @p i is row @p i.
+constexpr std::uint64_t TransposeBits8(std::uint64_t matrix) noexcept {
+    auto t {(matrix ^ (matrix >> 7)) & 0x00AA'00AA'00AA'00AA};
+    matrix ^= t ^ (t << 7);
+    t = (matrix ^ (matrix >> 14)) & 0x0000'CCCC'0000'CCCC;
+    matrix ^= t ^ (t << 14);
+    t = (matrix ^ (matrix >> 28)) & 0x0000'0000'F0F0'F0F0;
+    matrix ^= t ^ (t << 28);
+    return matrix;
+}
+
+//! Transpose a 64 × 64 bit matrix whose word @p i is row @p i, in place.
+constexpr void TransposeBits64(std::array<std::uint64_t, 64>& matrix) noexcept {
+    std::uint64_t mask {0x0000'0000'FFFF'FFFF};
+    for (std::size_t width {32}; width != 0; width >>= 1, mask ^= mask << width) {
+        // Swap the upper-right and lower-left sub-blocks of every block of size 2 * width.
+        for (std::size_t k {0}; k < matrix.size(); k = ((k | width) + 1) & ~width) {
+            const auto t {((matrix[k] >> width) ^ matrix[k | width]) & mask};
+            matrix[k] ^= t << width;
+            matrix[k | width] ^= t;
+        }
+    }
+}
+
+//! Get the number of words of a bitmap over rows.
+constexpr std::size_t BitmapWordCount(const std::size_t row_count) noexcept {
+    constexpr std::size_t word_bits {std::numeric_limits<std::uint64_t>::digits};
+    return (row_count + word_bits - 1) / word_bits;
+}
+
+/**
+ * @brief Transpose rows of flags into per-flag bitmaps.
+ *
+ * @param rows Rows of flags.
+ * @param thread_count The maximum number of threads.
+ * @return <tt>FlagTraits<Enum>::bit_width</tt> bitmaps of @ref BitmapWordCount words each.
+ */
+template <typename Enum>
+std::vector<std::uint64_t> TransposeToBitmaps(
+    const std::span<const EnumFlags<Enum>> rows,
+    const std::size_t thread_count = DefaultThreadCount()) {
+    using RawType = EnumFlags<Enum>::RawType;
+    constexpr std::size_t bit_count {FlagTraits<Enum>::bit_width};
+    const auto word_count {BitmapWordCount(rows.size())};
+    std::vector<std::uint64_t> bitmaps(bit_count * word_count);
+    ParallelFor(
+        word_count,
+        [rows, word_count, &bitmaps](const std::size_t begin, const std::size_t end) noexcept {
+            for (auto word {begin}; word != end; ++word) {
+                const auto block {rows.subspan(word * 64, std::min<std::size_t>(
+                                                              64, rows.size() - word * 64))};
+                std::array<std::uint64_t, 64> matrix {};
+                if constexpr (bit_count <= CHAR_BIT) {
+                    for (std::size_t group {0}; group * 8 < block.size(); ++group) {
+                        std::uint64_t packed {0};
+                        for (std::size_t i {group * 8}; i != std::min(group * 8 + 8, block.size());
+                             ++i) {
+                            packed |= (static_cast<RawType>(block[i]) & 0xFFULL) << i % 8 * 8;
+                        }
+
+                        packed = TransposeBits8(packed);
+                        for (std::size_t bit {0}; bit != bit_count; ++bit) {
+                            matrix[bit] |= (packed >> bit * 8 & 0xFF) << group * 8;
+                        }
+                    }
+                } else {
+                    for (std::size_t i {0}; i != block.size(); ++i) {
+                        matrix[i] = static_cast<RawType>(block[i]);
+                    }
+
+                    TransposeBits64(matrix);
+                }
+
+                for (std::size_t bit {0}; bit != bit_count; ++bit) {
+                    bitmaps[bit * word_count + word] = matrix[bit];
+                }
+            }
+        },
+        thread_count, 4096 / 64);
+    return bitmaps;
+}
+
+/**
+ * @brief Transpose per-flag bitmaps back into rows of flags.
+ *
+ * @param bitmaps <tt>FlagTraits<Enum>::bit_width</tt> bitmaps over <tt>rows.size()</tt> rows,
+ * as produced by @ref TransposeToBitmaps.
+ * @param rows A buffer for the rows.
+ * @param thread_count The maximum number of threads.
+ */
+template <typename Enum>
+void TransposeToRows(const std::span<const std::uint64_t> bitmaps,
+                     const std::span<EnumFlags<Enum>> rows,
+                     const std::size_t thread_count = DefaultThreadCount()) {
+    using RawType = EnumFlags<Enum>::RawType;
+    constexpr std::size_t bit_count {FlagTraits<Enum>::bit_width};
+    const auto word_count {BitmapWordCount(rows.size())};
+    ParallelFor(
+        word_count,
+        [bitmaps, rows, word_count](const std::size_t begin, const std::size_t end) noexcept {
+            for (auto word {begin}; word != end; ++word) {
+                const auto block {rows.subspan(word * 64, std::min<std::size_t>(
+                                                              64, rows.size() - word * 64))};
+                std::array<std::uint64_t, 64> matrix {};
+                for (std::size_t bit {0}; bit != bit_count; ++bit) {
+                    matrix[bit] = bitmaps[bit * word_count + word];
+                }
+
+                if constexpr (bit_count <= CHAR_BIT) {
+                    for (std::size_t group {0}; group * 8 < block.size(); ++group) {
+                        std::uint64_t packed {0};
+                        for (std::size_t bit {0}; bit != bit_count; ++bit) {
+                            packed |= (matrix[bit] >> group * 8 & 0xFF) << bit * 8;
+                        }
+
+                        packed = TransposeBits8(packed);
+                        for (std::size_t i {group * 8}; i != std::min(group * 8 + 8, block.size());
+                             ++i) {
+                            block[i] = static_cast<RawType>(packed >> i % 8 * 8 & 0xFF);
+                        }
+                    }
+                } else {
+                    TransposeBits64(matrix);
+                    for (std::size_t i {0}; i != block.size(); ++i) {
+                        block[i] = static_cast<RawType>(matrix[i]);
+                    }
+                }
+            }
+        },
+        thread_count, 4096 / 64);
+}
@@ -0,0 +1,230 @@
+/**
+ * @file hamming_search.h
+ * @brief Hamming-distance similarity search over @p EnumFlags.
+ *
+ * @details
+ * The Hamming distance of two flag sets is the number of flags set in only one of them.
+ *
+ * - @ref NearestNeighbors is an exact k-nearest-neighbor scan.
+ *   It computes distances for a block of rows in a branch-free loop the compiler can vectorize,
+ *   then only touches a bounded heap for rows closer than the current k-th neighbor.
+ * - @ref MultiIndexHashTable splits the bits into substrings indexed by separate hash tables.
+ *   A radius query only verifies the rows close to the query in at least one substring.
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ */
+
+#pragma once
+
+#include "enum_flags.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+//! A row found by a Hamming-distance search.
+struct HammingNeighbor {
+    //! The index of the row.
+    std::size_t index;
+
+    //! The Hamming distance to the query.
+    std::size_t distance;
+
+    //! Order neighbors by distance, then by index.
+    constexpr auto operator<=>(const HammingNeighbor& o) const noexcept {
+        return distance != o.distance ? distance <=> o.distance : index <=> o.index;
+    }
+
+    constexpr bool operator==(const HammingNeighbor&) const noexcept = default;
+};
+
+//! Get the number of flags set in only one of two flag sets.
+template <typename Enum>
+constexpr std::size_t HammingDistance(const EnumFlags<Enum> lhs,
+                                      const EnumFlags<Enum> rhs) noexcept {
+    using RawType = EnumFlags<Enum>::RawType;
+    return static_cast<std::size_t>(
+        std::popcount(static_cast<RawType>(static_cast<RawType>(lhs) ^ static_cast<RawType>(rhs))));
+}
+
+/**
+ * @brief Find the @p k rows closest to a query.
+ *
+ * @return Up to @p k neighbors, ordered by distance and then by index.
+ */
+template <typename Enum>
+std::vector<HammingNeighbor> NearestNeighbors(const std::span<const EnumFlags<Enum>> rows,
+                                              const EnumFlags<Enum> query, const std::size_t k) {
+    using RawType = EnumFlags<Enum>::RawType;
+    constexpr std::size_t block_size {64};
+
+    std::vector<HammingNeighbor> heap;
+    if (k == 0) {
+        return heap;
+    }
+
+    heap.reserve(k);
+    // Rows no closer than the current k-th neighbor are skipped without touching the heap.
+    auto bound {std::numeric_limits<std::size_t>::max()};
+    std::array<std::uint8_t, block_size> distances;
+    const auto q {static_cast<RawType>(query)};
+    for (std::size_t begin {0}; begin < rows.size(); begin += block_size) {
+        const auto size {std::min(block_size, rows.size() - begin)};
+        for (std::size_t i {0}; i != size; ++i) {
+            distances[i] = static_cast<std::uint8_t>(
+                std::popcount(static_cast<RawType>(static_cast<RawType>(rows[begin + i]) ^ q)));
+        }
+
+        for (std::size_t i {0}; i != size; ++i) {
+            if (distances[i] >= bound) {
+                continue;
+            }
+
+            const HammingNeighbor neighbor {begin + i, distances[i]};
+            if (heap.size() == k) {
+                std::ranges::pop_heap(heap);
+                heap.back() = neighbor;
+            } else {
+                heap.push_back(neighbor);
+            }
+
+            std::ranges::push_heap(heap);
+            if (heap.size() == k) {
+                bound = heap.front().distance;
+            }
+        }
+    }
+
+    std::ranges::sort_heap(heap);
+    return heap;
+}
+
+/**
+ * @brief A multi-index hash table for Hamming-distance radius queries.
+ *
+ * @details
+ * The bits are split into @p m disjoint substrings, each indexed by its own hash table.
+ * If a row is within distance @p r of a query,
+ * at least one of its substrings is within distance @p r/m of the query's substring.
+ * A radius query therefore probes each table with the substring values within that distance
+ * and verifies the full distance of the candidates only.
+ */
+template <typename Enum>
+class MultiIndexHashTable {
+public:
+    using Flags = EnumFlags<Enum>;
+    using RawType = Flags::RawType;
+
+    //! The number of bits up to the highest valid flag, which are split into substrings.
+    static constexpr std::size_t bit_count {FlagTraits<Enum>::bit_width};
+
+    /**
+     * @brief Create an empty table.
+     *
+     * @param substring_count The number of substrings, clamped to the number of bits.
+     */
+    explicit MultiIndexHashTable(const std::size_t substring_count) :
+        tables_(std::clamp<std::size_t>(substring_count, 1, bit_count)) {
+        const auto m {tables_.size()};
+        std::size_t shift {0};
+        for (std::size_t i {0}; i != m; ++i) {
+            auto& table {tables_[i]};
+            table.shift = shift;
+            table.width = bit_count / m + (i < bit_count % m ? 1 : 0);
+            shift += table.width;
+        }
+    }
+
+    //! Insert a row and get its index.
+    std::size_t Insert(const Flags flags) {
+        const auto index {rows_.size()};
+        rows_.push_back(flags);
+        for (auto& table : tables_) {
+            table.buckets[table.Substring(flags)].push_back(index);
+        }
+
+        return index;
+    }
+
+    //! Get the number of rows.
+    std::size_t Size() const noexcept {
+        return rows_.size();
+    }
+
+    //! Get a row.
+    Flags operator[](const std::size_t index) const noexcept {
+        return rows_[index];
+    }
+
+    /**
+     * @brief Find all rows within a distance of a query.
+     *
+     * @return Neighbors ordered by distance and then by index.
+     */
+    std::vector<HammingNeighbor> RadiusSearch(const Flags query, const std::size_t radius) const {
+        const auto sub_radius {radius / tables_.size()};
+        std::vector<std::size_t> candidates;
+        for (const auto& table : tables_) {
+            const auto probe {[&table, &candidates](const std::uint64_t key) {
+                if (const auto it {table.buckets.find(key)}; it != table.buckets.cend()) {
+                    candidates.insert(candidates.end(), it->second.cbegin(), it->second.cend());
+                }
+            }};
+
+            table.ForEachWithin(table.Substring(query), sub_radius, probe);
+        }
+
+        std::ranges::sort(candidates);
+        const auto [first, last] {std::ranges::unique(candidates)};
+        candidates.erase(first, last);
+
+        std::vector<HammingNeighbor> neighbors;
+        for (const auto index : candidates) {
+            if (const auto distance {HammingDistance(rows_[index], query)}; distance <= radius) {
+                neighbors.push_back({index, distance});
+            }
+        }
+
+        std::ranges::sort(neighbors);
+        return neighbors;
+    }
+
+private:
+    struct Table {
+        std::uint64_t Substring(const Flags flags) const noexcept {
+            const auto value {static_cast<std::uint64_t>(static_cast<RawType>(flags)) >> shift};
+            return width == std::numeric_limits<std::uint64_t>::digits
+                       ? value
+                       : value & ((std::uint64_t {1} << width) - 1);
+        }
+
+        //! Call a function with each substring value within a distance of a key.
+        template <typename Func>
+        void ForEachWithin(const std::uint64_t key, const std::size_t radius, Func&& func,
+                           const std::size_t first_bit = 0) const {
+            func(key);
+            if (radius == 0) {
+                return;
+            }
+
+            for (auto bit {first_bit}; bit < width; ++bit) {
+                ForEachWithin(key ^ (std::uint64_t {1} << bit), radius - 1, func, bit + 1);
+            }
+        }
+
+        std::size_t shift {0};
+        std::size_t width {0};
+        std::unordered_map<std::uint64_t, std::vector<std::size_t>> buckets;
+    };
+
+    std::vector<Table> tables_;
+    std::vector<Flags> rows_;
+};
@@ -0,0 +1,110 @@
+/**
+ * @file implication_graph.h
+ * @brief Transitive implications between flags, closed at compile time.
+ *
+ * @details
+ * The transitive closure of the implications is stored as a bit matrix,
+ * with one row per flag holding the flag and every flag it implies.
+ * It is computed when the graph is constructed,
+ * which happens at compile time for a @p constexpr graph.
+ *
+ * Closing flags at runtime looks up one precomputed entry per byte of the flags
+ * and ORs the results, without iterating to a fixed point.
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ */
+
+#pragma once
+
+#include "enum_flags.h"
+
+#include <array>
+#include <bit>
+#include <climits>
+#include <cstddef>
+#include <initializer_list>
+#include <utility>
+
+//! Transitive implications between flags of an enumeration.
+template <typename Enum>
+class ImplicationGraph {
+public:
+    using Flags = EnumFlags<Enum>;
+    using RawType = Flags::RawType;
+
+    //! Every flag in @p from implies all flags in @p to.
+    struct Implication {
+        Flags from;
+        Flags to;
+    };
+
+    //! Create a graph and compute its transitive closure.
+    constexpr ImplicationGraph(const std::initializer_list<Implication> implications) noexcept {
+        for (std::size_t i {0}; i != bit_count; ++i) {
+            rows_[i] = static_cast<RawType>(RawType {1} << i);
+        }
+
+        for (const auto& [from, to] : implications) {
+            Flags {from}.Sanitize().ForEachBit(
+                [this, to](const std::size_t i) noexcept { rows_[i] |= Flags {to}.Sanitize(); });
+        }
+
+        // Warshall's algorithm: a flag implying @p k also implies everything @p k implies.
+        for (std::size_t k {0}; k != bit_count; ++k) {
+            for (auto& row : rows_) {
+                if ((row >> k & 1) != 0) {
+                    row |= rows_[k];
+                }
+            }
+        }
+
+        for (std::size_t byte {0}; byte != byte_count; ++byte) {
+            auto& table {tables_[byte]};
+            for (std::size_t value {1}; value != table.size(); ++value) {
+                const auto bit {byte * CHAR_BIT
+                                + static_cast<std::size_t>(std::countr_zero(value))};
+                // Bits beyond the highest valid flag are removed before lookups.
+                const auto row {bit < bit_count ? rows_[bit] : RawType {0}};
+                table[value] = static_cast<RawType>(table[value & (value - 1)] | row);
+            }
+        }
+    }
+
+    //! Get a flag and all flags it implies.
+    constexpr Flags Implied(const Enum flag) const noexcept {
+        return rows_[std::countr_zero(std::to_underlying(flag))];
+    }
+
+    //! Check whether a flag implies another flag, directly or transitively.
+    constexpr bool Implies(const Enum from, const Enum to) const noexcept {
+        return Implied(from).Has(to);
+    }
+
+    //! Get flags together with all flags they imply. Bits that are not valid flags are removed.
+    constexpr Flags Close(const Flags flags) const noexcept {
+        auto raw {static_cast<RawType>(Flags {flags}.Sanitize())};
+        RawType closed {0};
+        for (std::size_t byte {0}; raw != 0; ++byte, raw >>= CHAR_BIT) {
+            closed |= tables_[byte][raw & byte_mask];
+        }
+
+        return closed;
+    }
+
+    //! Check whether valid flags already contain everything they imply.
+    constexpr bool IsClosed(const Flags flags) const noexcept {
+        return Close(flags) == Flags {flags}.Sanitize();
+    }
+
+private:
+    static constexpr std::size_t bit_count {FlagTraits<Enum>::bit_width};
+    static constexpr std::size_t byte_count {(bit_count + CHAR_BIT - 1) / CHAR_BIT};
+    static constexpr std::size_t byte_mask {(std::size_t {1} << CHAR_BIT) - 1};
+
+    //! For each flag, the flag and every flag it implies.
+    std::array<RawType, bit_count> rows_ {};
+
+    //! For each byte of flags and each value of the byte, the union of the rows of its bits.
+    std::array<std::array<RawType, byte_mask + 1>, byte_count> tables_ {};
+};
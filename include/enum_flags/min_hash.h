@@ -0,0 +1,259 @@
+/**
+ * @file min_hash.h
+ * @brief MinHash signatures and locality-sensitive hashing for Jaccard similarity of @p EnumFlags.
+ *
+ * @details
+ * The Jaccard similarity of two flag sets is the number of common flags
+ * divided by the number of flags set in either of them.
+ *
+ * - @ref MinHasher computes MinHash signatures by visiting only the set bits.
+ *   The probability that two signatures agree on a component equals the Jaccard similarity.
+ * - @ref MinHashLshIndex splits signatures into bands and indexes each band in a hash table.
+ *   Flag sets sharing at least one band become candidates, avoiding pairwise comparisons.
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ */
+
+#pragma once
+
+#include "enum_flags.h"
+#include "parallel.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+//! Get the number of common flags divided by the number of flags set in either flag set.
+template <typename Enum>
+constexpr double JaccardSimilarity(const EnumFlags<Enum> lhs, const EnumFlags<Enum> rhs) noexcept {
+    using RawType = EnumFlags<Enum>::RawType;
+    const auto all {(lhs | rhs).Count()};
+    const auto common {
+        std::popcount(static_cast<RawType>(static_cast<RawType>(lhs) & static_cast<RawType>(rhs)))};
+    return all == 0 ? 1.0 : static_cast<double>(common) / static_cast<double>(all);
+}
+
+//! A MinHash signature generator for @p EnumFlags.
+template <typename Enum>
+class MinHasher {
+public:
+    using Flags = EnumFlags<Enum>;
+    using RawType = Flags::RawType;
+    using Value = std::uint32_t;
+
+    //! The number of bits up to the highest valid flag, each mapped by every hash function.
+    static constexpr std::size_t bit_count {FlagTraits<Enum>::bit_width};
+
+    //! The signature component of an empty flag set.
+    static constexpr Value empty_value {std::numeric_limits<Value>::max()};
+
+    /**
+     * @brief Create a generator.
+     *
+     * @param hash_count The number of hash functions, which is the length of a signature.
+     * @param seed A seed for the hash functions.
+     */
+    explicit MinHasher(const std::size_t hash_count, const std::uint64_t seed = 0) :
+        hashes_(hash_count * bit_count) {
+        // Each hash function maps every bit to a random value.
+        auto state {seed};
+        for (auto& hash : hashes_) {
+            hash = static_cast<Value>(SplitMix64(state) >> 32);
+        }
+    }
+
+    //! Get the length of a signature.
+    std::size_t HashCount() const noexcept {
+        return hashes_.size() / bit_count;
+    }
+
+    /**
+     * @brief Compute the signature of a flag set.
+     *
+     * @param flags A flag set. Bits that are not valid flags are ignored.
+     * @param signature A buffer of @ref HashCount elements.
+     */
+    void Sign(const Flags flags, const std::span<Value> signature) const noexcept {
+        std::ranges::fill(signature, empty_value);
+        Flags {flags}.Sanitize().ForEachBit([this, signature](const std::size_t bit) noexcept {
+            for (std::size_t i {0}; i != signature.size(); ++i) {
+                signature[i] = std::min(signature[i], hashes_[i * bit_count + bit]);
+            }
+        });
+    }
+
+    //! Compute the signature of a flag set.
+    std::vector<Value> Sign(const Flags flags) const {
+        std::vector<Value> signature(HashCount());
+        Sign(flags, signature);
+        return signature;
+    }
+
+    /**
+     * @brief Compute the signatures of flag sets in parallel.
+     *
+     * @param flags Flag sets.
+     * @param signatures A buffer of @ref HashCount elements per flag set, stored contiguously.
+     * @param thread_count The maximum number of threads.
+     */
+    void Sign(const std::span<const Flags> flags, const std::span<Value> signatures,
+              const std::size_t thread_count = DefaultThreadCount()) const {
+        const auto length {HashCount()};
+        ParallelFor(
+            flags.size(),
+            [this, flags, signatures, length](const std::size_t begin, const std::size_t end) {
+                for (auto i {begin}; i != end; ++i) {
+                    Sign(flags[i], signatures.subspan(i * length, length));
+                }
+            },
+            thread_count);
+    }
+
+    //! Estimate the Jaccard similarity of two flag sets from their signatures.
+    static double Similarity(const std::span<const Value> lhs,
+                             const std::span<const Value> rhs) noexcept {
+        if (lhs.empty()) {
+            return 1.0;
+        }
+
+        std::size_t equal {0};
+        for (std::size_t i {0}; i != lhs.size(); ++i) {
+            equal += lhs[i] == rhs[i];
+        }
+
+        return static_cast<double>(equal) / static_cast<double>(lhs.size());
+    }
+
+private:
+    static constexpr std::uint64_t SplitMix64(std::uint64_t& state) noexcept {
+        auto z {state += 0x9E3779B97F4A7C15};
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+        return z ^ (z >> 31);
+    }
+
+    //! The hash value of each bit for each hash function, row-major by hash function.
+    std::vector<Value> hashes_;
+};
+
+/**
+ * @brief A locality-sensitive hashing index over MinHash signatures.
+ *
+ * @details
+ * A signature is split into @p b bands of @p r components.
+ * Two flag sets with Jaccard similarity @p s share at least one band
+ * with probability <tt>1 - (1 - s^r)^b</tt>.
+ */
+template <typename Enum>
+class MinHashLshIndex {
+public:
+    using Flags = EnumFlags<Enum>;
+    using Value = MinHasher<Enum>::Value;
+
+    /**
+     * @brief Create an empty index.
+     *
+     * @param band_count The number of bands.
+     * @param rows_per_band The number of signature components per band.
+     * @param seed A seed for the hash functions.
+     */
+    MinHashLshIndex(const std::size_t band_count, const std::size_t rows_per_band,
+                    const std::uint64_t seed = 0) :
+        hasher_ {std::max<std::size_t>(band_count, 1) * std::max<std::size_t>(rows_per_band, 1),
+                 seed},
+        rows_per_band_ {std::max<std::size_t>(rows_per_band, 1)},
+        bands_(std::max<std::size_t>(band_count, 1)) {}
+
+    //! Insert a flag set and get its index.
+    std::size_t Insert(const Flags flags) {
+        return Insert(flags, hasher_.Sign(flags));
+    }
+
+    /**
+     * @brief Insert flag sets, computing their signatures in parallel.
+     *
+     * @return The index of the first inserted flag set.
+     */
+    std::size_t Insert(const std::span<const Flags> flags,
+                       const std::size_t thread_count = DefaultThreadCount()) {
+        const auto first {rows_.size()};
+        const auto length {hasher_.HashCount()};
+        std::vector<Value> signatures(flags.size() * length);
+        hasher_.Sign(flags, signatures, thread_count);
+        for (std::size_t i {0}; i != flags.size(); ++i) {
+            Insert(flags[i], std::span {signatures}.subspan(i * length, length));
+        }
+
+        return first;
+    }
+
+    //! Get the number of flag sets.
+    std::size_t Size() const noexcept {
+        return rows_.size();
+    }
+
+    //! Get a flag set.
+    Flags operator[](const std::size_t index) const noexcept {
+        return rows_[index];
+    }
+
+    //! Get the sorted indices of flag sets sharing at least one band with a query.
+    std::vector<std::size_t> Candidates(const Flags query) const {
+        const auto signature {hasher_.Sign(query)};
+        std::vector<std::size_t> candidates;
+        for (std::size_t band {0}; band != bands_.size(); ++band) {
+            const auto& table {bands_[band]};
+            if (const auto it {table.find(HashBand(signature, band))}; it != table.cend()) {
+                candidates.insert(candidates.end(), it->second.cbegin(), it->second.cend());
+            }
+        }
+
+        std::ranges::sort(candidates);
+        const auto [first, last] {std::ranges::unique(candidates)};
+        candidates.erase(first, last);
+        return candidates;
+    }
+
+    //! Get the sorted indices of candidates whose exact Jaccard similarity reaches a threshold.
+    std::vector<std::size_t> Query(const Flags query, const double threshold) const {
+        auto candidates {Candidates(query)};
+        std::erase_if(candidates, [this, query, threshold](const std::size_t i) noexcept {
+            return JaccardSimilarity(rows_[i], query) < threshold;
+        });
+
+        return candidates;
+    }
+
+private:
+    std::uint64_t HashBand(const std::span<const Value> signature,
+                           const std::size_t band) const noexcept {
+        // FNV-1a over the components of the band.
+        std::uint64_t hash {0xCBF29CE484222325};
+        for (const auto value : signature.subspan(band * rows_per_band_, rows_per_band_)) {
+            hash = (hash ^ value) * 0x100000001B3;
+        }
+
+        return hash;
+    }
+
+    std::size_t Insert(const Flags flags, const std::span<const Value> signature) {
+        const auto index {rows_.size()};
+        rows_.push_back(flags);
+        for (std::size_t band {0}; band != bands_.size(); ++band) {
+            bands_[band][HashBand(signature, band)].push_back(index);
+        }
+
+        return index;
+    }
+
+    MinHasher<Enum> hasher_;
+    std::size_t rows_per_band_;
+    std::vector<std::unordered_map<std::uint64_t, std::vector<std::size_t>>> bands_;
+    std::vector<Flags> rows_;
+};
@@ -0,0 +1,267 @@
+/**
+ * @file observable_flags.h
+ * @brief @p EnumFlags notifying subscribers of rising and falling edges.
+ *
+ * @details
+ * A subscriber registers a mask and the edges it cares about.
+ * For each bit and direction, a bitmap records the interested subscribers,
+ * so a mutation computes its changed bits once and merges the bitmaps of those bits only.
+ *
+ * In batched mode, mutations only accumulate their edges.
+ * @ref ObservableFlags::Flush then notifies each affected subscriber once per tick.
+ * A flag that rises and falls within a tick is reported with both edges.
+ *
+ * Subscribers are called synchronously and the flags are not thread-safe.
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ */
+
+#pragma once
+
+#include "enum_flags.h"
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <utility>
+#include <vector>
+
+//! The direction of a flag change.
+enum class FlagEdge : unsigned int {
+    Rising = EnumFlags<FlagEdge>::CreateFlag(0),
+    Falling = EnumFlags<FlagEdge>::CreateFlag(1)
+};
+
+//! @p EnumFlags notifying subscribers of rising and falling edges.
+template <typename Enum>
+class ObservableFlags {
+public:
+    using Flags = EnumFlags<Enum>;
+    using RawType = Flags::RawType;
+
+    //! Changes reported to a subscriber, restricted to its mask and edges.
+    struct Change {
+        //! Flags that have been set.
+        Flags rising;
+
+        //! Flags that have been cleared.
+        Flags falling;
+
+        //! The flags after the changes.
+        Flags flags;
+    };
+
+    using Callback = std::function<void(const Change&)>;
+
+    /**
+     * @brief Create flags.
+     *
+     * @param flags Initial flags.
+     * @param batched Whether to notify subscribers in @ref Flush instead of after each mutation.
+     */
+    explicit ObservableFlags(const Flags flags = {}, const bool batched = false) noexcept :
+        flags_ {flags}, batched_ {batched} {}
+
+    ObservableFlags(const ObservableFlags&) = delete;
+
+    ObservableFlags& operator=(const ObservableFlags&) = delete;
+
+    //! Get the flags.
+    Flags Load() const noexcept {
+        return flags_;
+    }
+
+    //! Check whether a flag is set.
+    bool Has(const Enum flag) const noexcept {
+        return flags_.Has(flag);
+    }
+
+    //! Check whether all specific flags are set.
+    bool HasAll(const Flags flags) const noexcept {
+        return flags_.HasAll(flags);
+    }
+
+    //! Check whether at least one of the specific flags is set.
+    bool HasAny(const Flags flags) const noexcept {
+        return flags_.HasAny(flags);
+    }
+
+    /**
+     * @brief Register a subscriber.
+     *
+     * @details
+     * It must not be called from a subscriber.
+     *
+     * @param mask Flags to watch.
+     * @param edges The directions of change to watch.
+     * @param callback A function called with the changes of watched flags.
+     * @return A subscription ID for @ref Unsubscribe.
+     */
+    std::size_t Subscribe(const Flags mask, const EnumFlags<FlagEdge> edges, Callback callback) {
+        std::size_t id {subscribers_.size()};
+        if (!free_ids_.empty()) {
+            id = free_ids_.back();
+            free_ids_.pop_back();
+            subscribers_[id] = {Flags {mask}.Sanitize(), edges, std::move(callback), true};
+        } else {
+            subscribers_.push_back({Flags {mask}.Sanitize(), edges, std::move(callback), true});
+            if (id % word_bits == 0) {
+                for (auto& bitmap : rising_subscribers_) {
+                    bitmap.push_back(0);
+                }
+
+                for (auto& bitmap : falling_subscribers_) {
+                    bitmap.push_back(0);
+                }
+            }
+        }
+
+        Mark(id, true);
+        return id;
+    }
+
+    /**
+     * @brief Remove a subscriber. It may be called from a subscriber.
+     *
+     * @return Whether the subscriber has been removed,
+     * or @p false if the ID is unknown or has already been removed.
+     */
+    bool Unsubscribe(const std::size_t id) {
+        if (id >= subscribers_.size() || !subscribers_[id].live) {
+            return false;
+        }
+
+        Mark(id, false);
+        subscribers_[id].live = false;
+        free_ids_.push_back(id);
+        return true;
+    }
+
+    //! Add specific flags.
+    void Add(const Flags flags) {
+        Set(Flags {flags_}.Add(flags));
+    }
+
+    //! Remove specific flags.
+    void Remove(const Flags flags) {
+        Set(Flags {flags_}.Remove(flags));
+    }
+
+    //! Reset the flags.
+    void Set(const Flags flags) {
+        const auto old {static_cast<RawType>(flags_)};
+        const auto changed {static_cast<RawType>(old ^ static_cast<RawType>(flags))};
+        flags_ = flags;
+        if (changed == 0) {
+            return;
+        }
+
+        // Bits that are not valid flags have no subscribers.
+        const auto valid {static_cast<RawType>(Flags::All())};
+        const auto rising {static_cast<RawType>(changed & ~old & valid)};
+        const auto falling {static_cast<RawType>(changed & old & valid)};
+        if (batched_) {
+            pending_rising_ |= rising;
+            pending_falling_ |= falling;
+        } else {
+            Dispatch(rising, falling);
+        }
+    }
+
+    /**
+     * @brief Notify subscribers of the edges accumulated since the last tick.
+     *
+     * @details
+     * Mutations made by subscribers are accumulated for the next tick.
+     *
+     * @return The number of notified subscribers.
+     */
+    std::size_t Flush() {
+        return Dispatch(std::exchange(pending_rising_, 0), std::exchange(pending_falling_, 0));
+    }
+
+private:
+    static constexpr std::size_t bit_count {FlagTraits<Enum>::bit_width};
+    static constexpr std::size_t word_bits {std::numeric_limits<std::uint64_t>::digits};
+
+    struct Subscriber {
+        Flags mask;
+        EnumFlags<FlagEdge> edges;
+        Callback callback;
+
+        //! Whether the ID is in use rather than free.
+        bool live;
+    };
+
+    //! Set or clear a subscriber in the bitmaps of its watched bits.
+    void Mark(const std::size_t id, const bool subscribed) noexcept {
+        const auto& subscriber {subscribers_[id]};
+        const auto word {id / word_bits};
+        const auto bit {std::uint64_t {1} << id % word_bits};
+        subscriber.mask.ForEachBit([&](const std::size_t flag) noexcept {
+            if (subscriber.edges.Has(FlagEdge::Rising)) {
+                auto& w {rising_subscribers_[flag][word]};
+                w = subscribed ? w | bit : w & ~bit;
+            }
+
+            if (subscriber.edges.Has(FlagEdge::Falling)) {
+                auto& w {falling_subscribers_[flag][word]};
+                w = subscribed ? w | bit : w & ~bit;
+            }
+        });
+    }
+
+    //! Notify each subscriber watching one of the edges once.
+    std::size_t Dispatch(const RawType rising, const RawType falling) {
+        std::size_t count {0};
+        const auto flags {flags_};
+        for (std::size_t word {0}; word * word_bits < subscribers_.size(); ++word) {
+            std::uint64_t targets {0};
+            Flags {rising}.ForEachBit([this, word, &targets](const std::size_t flag) noexcept {
+                targets |= rising_subscribers_[flag][word];
+            });
+
+            Flags {falling}.ForEachBit([this, word, &targets](const std::size_t flag) noexcept {
+                targets |= falling_subscribers_[flag][word];
+            });
+
+            for (; targets != 0; targets &= targets - 1) {
+                const auto id {word * word_bits + std::countr_zero(targets)};
+                const auto& subscriber {subscribers_[id]};
+                if (!subscriber.live) {
+                    // It has been removed by an earlier subscriber.
+                    continue;
+                }
+
+                const auto mask {static_cast<RawType>(subscriber.mask)};
+                const auto edges {subscriber.edges};
+                const Change change {
+                    static_cast<RawType>(edges.Has(FlagEdge::Rising) ? rising & mask : 0),
+                    static_cast<RawType>(edges.Has(FlagEdge::Falling) ? falling & mask : 0),
+                    flags};
+                subscriber.callback(change);
+                ++count;
+            }
+        }
+
+        return count;
+    }
+
+    Flags flags_;
+    const bool batched_;
+    RawType pending_rising_ {0};
+    RawType pending_falling_ {0};
+
+    std::vector<Subscriber> subscribers_;
+    std::vector<std::size_t> free_ids_;
+
+    //! For each bit, a bitmap of subscribers watching its rising edge.
+    std::array<std::vector<std::uint64_t>, bit_count> rising_subscribers_;
+
+    //! For each bit, a bitmap of subscribers watching its falling edge.
+    std::array<std::vector<std::uint64_t>, bit_count> falling_subscribers_;
+};
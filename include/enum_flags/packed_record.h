@@ -0,0 +1,280 @@
+/**
+ * @file packed_record.h
+ * @brief Records packing several @p EnumFlags groups and small integers into one word.
+ *
+ * @details
+ * The layout is declared as a list of fields and computed at compile time.
+ * Fields are packed from the least significant bit in declaration order,
+ * into the smallest unsigned word that can hold all of them.
+ *
+ * - @ref FlagsField holds @p EnumFlags, taking <tt>FlagTraits<Enum>::bit_width</tt> bits.
+ * - @ref UIntField holds an unsigned integer of a fixed number of bits.
+ *
+ * @code {.cpp}
+ * using Record = PackedRecord<FlagsField<State>, FlagsField<Access>, UIntField<3>, UIntField<4>>;
+ * Record record {State::Open, {Access::Read, Access::Write}, 5, 9};
+ * record.Add<0>(State::Dirty);
+ * const auto priority {record.Get<2>()};
+ * @endcode
+ *
+ * Comparisons and filters work on the packed word directly.
+ * A @ref PackedRecord::Filter combines conditions on any fields into one mask and one value,
+ * so testing a record is a single AND and compare regardless of the number of conditions.
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ */
+
+#pragma once
+
+#include "enum_flags.h"
+#include "parallel.h"
+
+#include <array>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <tuple>
+#include <type_traits>
+
+//! Get a mask of the lowest @p width bits.
+constexpr std::uint64_t LowBitMask(const std::size_t width) noexcept {
+    return width >= std::numeric_limits<std::uint64_t>::digits
+               ? ~std::uint64_t {0}
+               : (std::uint64_t {1} << width) - 1;
+}
+
+//! A field of a @ref PackedRecord holding @p EnumFlags.
+template <typename E>
+struct FlagsField {
+    using Enum = E;
+    using Value = EnumFlags<Enum>;
+
+    static constexpr std::size_t width {FlagTraits<Enum>::bit_width};
+
+    //! Encode flags into the bits of the field. Bits that are not valid flags are removed.
+    static constexpr std::uint64_t Encode(const Value flags) noexcept {
+        return static_cast<Value::RawType>(Value {flags}.Sanitize());
+    }
+
+    static constexpr Value Decode(const std::uint64_t bits) noexcept {
+        return static_cast<Value::RawType>(bits);
+    }
+};
+
+//! A field of a @ref PackedRecord holding an unsigned integer of @p Width bits.
+template <std::size_t Width>
+    requires(Width > 0 && Width <= std::numeric_limits<std::uint64_t>::digits)
+struct UIntField {
+    using Value =
+        std::conditional_t<(Width <= std::numeric_limits<std::uint32_t>::digits), std::uint32_t,
+                           std::uint64_t>;
+
+    static constexpr std::size_t width {Width};
+
+    //! Encode an integer into the bits of the field. Higher bits are truncated.
+    static constexpr std::uint64_t Encode(const Value value) noexcept {
+        return value & LowBitMask(width);
+    }
+
+    static constexpr Value Decode(const std::uint64_t bits) noexcept {
+        return static_cast<Value>(bits);
+    }
+};
+
+//! Check whether a type is a field of a @ref PackedRecord.
+template <typename T>
+concept PackedField = requires(const typename T::Value value, const std::uint64_t bits) {
+    { T::width } -> std::convertible_to<std::size_t>;
+    { T::Encode(value) } -> std::same_as<std::uint64_t>;
+    { T::Decode(bits) } -> std::same_as<typename T::Value>;
+};
+
+//! A record packing fields into one word with a compile-time layout.
+template <PackedField... Fields>
+    requires(sizeof...(Fields) > 0)
+class PackedRecord {
+public:
+    //! The number of bits used by all fields.
+    static constexpr std::size_t bit_count {(Fields::width + ...)};
+
+    static_assert(bit_count <= std::numeric_limits<std::uint64_t>::digits,
+                  "The fields of a packed record must fit in 64 bits.");
+
+    //! The smallest unsigned word holding all fields.
+    using Word = std::conditional_t<
+        (bit_count <= 8), std::uint8_t,
+        std::conditional_t<(bit_count <= 16), std::uint16_t,
+                           std::conditional_t<(bit_count <= 32), std::uint32_t, std::uint64_t>>>;
+
+    template <std::size_t I>
+    using Field = std::tuple_element_t<I, std::tuple<Fields...>>;
+
+    template <std::size_t I>
+    using Value = Field<I>::Value;
+
+    //! The position of the lowest bit of each field.
+    static constexpr std::array<std::size_t, sizeof...(Fields)> offsets {[] {
+        std::array<std::size_t, sizeof...(Fields)> offsets {};
+        const std::array<std::size_t, sizeof...(Fields)> widths {Fields::width...};
+        for (std::size_t i {1}; i != offsets.size(); ++i) {
+            offsets[i] = offsets[i - 1] + widths[i - 1];
+        }
+
+        return offsets;
+    }()};
+
+    //! The bits of a field in the word.
+    template <std::size_t I>
+    static constexpr Word mask {static_cast<Word>(LowBitMask(Field<I>::width) << offsets[I])};
+
+    //! Conditions on fields, tested on the packed word with one AND and one compare.
+    class Filter {
+    public:
+        constexpr Filter() noexcept = default;
+
+        //! Require a field to equal a value.
+        template <std::size_t I>
+        constexpr Filter& Equal(const Value<I> value) noexcept {
+            return Require(mask<I>, Encode<I>(value));
+        }
+
+        //! Require all specific flags of a flag field to be set.
+        template <std::size_t I>
+            requires std::same_as<Field<I>, FlagsField<typename Field<I>::Enum>>
+        constexpr Filter& HasAll(const Value<I> flags) noexcept {
+            const auto bits {Encode<I>(flags)};
+            return Require(bits, bits);
+        }
+
+        //! Require all specific flags of a flag field to be cleared.
+        template <std::size_t I>
+            requires std::same_as<Field<I>, FlagsField<typename Field<I>::Enum>>
+        constexpr Filter& HasNone(const Value<I> flags) noexcept {
+            return Require(Encode<I>(flags), 0);
+        }
+
+        //! Check whether a record satisfies all conditions.
+        constexpr bool Matches(const PackedRecord record) const noexcept {
+            return static_cast<Word>(record.word_ & mask_) == value_;
+        }
+
+        //! Use the filter as a predicate.
+        constexpr bool operator()(const PackedRecord record) const noexcept {
+            return Matches(record);
+        }
+
+    private:
+        //! Require the bits in @p bits to equal those in @p value, replacing earlier conditions.
+        constexpr Filter& Require(const Word bits, const Word value) noexcept {
+            mask_ = static_cast<Word>(mask_ | bits);
+            value_ = static_cast<Word>((value_ & ~bits) | value);
+            return *this;
+        }
+
+        Word mask_ {0};
+        Word value_ {0};
+    };
+
+    constexpr PackedRecord() noexcept = default;
+
+    //! Create a record from the values of all fields.
+    explicit constexpr PackedRecord(const typename Fields::Value... values) noexcept {
+        Assign<0>(values...);
+    }
+
+    //! Create a record from a packed word. Bits not used by any field are cleared.
+    static constexpr PackedRecord FromRaw(const Word word) noexcept {
+        PackedRecord record;
+        record.word_ = static_cast<Word>(word & LowBitMask(bit_count));
+        return record;
+    }
+
+    //! Get the packed word.
+    constexpr Word Raw() const noexcept {
+        return word_;
+    }
+
+    //! Get the value of a field.
+    template <std::size_t I>
+    constexpr Value<I> Get() const noexcept {
+        return Field<I>::Decode((word_ & mask<I>) >> offsets[I]);
+    }
+
+    //! Set the value of a field.
+    template <std::size_t I>
+    constexpr PackedRecord& Set(const Value<I> value) noexcept {
+        word_ = static_cast<Word>((word_ & ~mask<I>) | Encode<I>(value));
+        return *this;
+    }
+
+    //! Check whether a flag of a flag field is set.
+    template <std::size_t I>
+        requires std::same_as<Field<I>, FlagsField<typename Field<I>::Enum>>
+    constexpr bool Has(const typename Field<I>::Enum flag) const noexcept {
+        const auto bits {Encode<I>(flag)};
+        return bits != 0 && (word_ & bits) == bits;
+    }
+
+    //! Add specific flags to a flag field.
+    template <std::size_t I>
+        requires std::same_as<Field<I>, FlagsField<typename Field<I>::Enum>>
+    constexpr PackedRecord& Add(const Value<I> flags) noexcept {
+        word_ = static_cast<Word>(word_ | Encode<I>(flags));
+        return *this;
+    }
+
+    //! Remove specific flags from a flag field.
+    template <std::size_t I>
+        requires std::same_as<Field<I>, FlagsField<typename Field<I>::Enum>>
+    constexpr PackedRecord& Remove(const Value<I> flags) noexcept {
+        word_ = static_cast<Word>(word_ & ~Encode<I>(flags));
+        return *this;
+    }
+
+    /**
+     * @brief Count the records satisfying a filter.
+     *
+     * @param records Records.
+     * @param filter A filter.
+     * @param thread_count The maximum number of threads.
+     */
+    static std::size_t Count(const std::span<const PackedRecord> records, const Filter& filter,
+                             const std::size_t thread_count = DefaultThreadCount()) {
+        std::atomic_size_t count {0};
+        ParallelFor(
+            records.size(),
+            [records, &filter, &count](const std::size_t begin, const std::size_t end) noexcept {
+                std::size_t part {0};
+                for (auto i {begin}; i != end; ++i) {
+                    part += static_cast<std::size_t>(filter.Matches(records[i]));
+                }
+
+                count.fetch_add(part, std::memory_order_relaxed);
+            },
+            thread_count);
+        return count.load(std::memory_order_relaxed);
+    }
+
+    constexpr bool operator==(const PackedRecord&) const noexcept = default;
+
+private:
+    //! Encode a value into its bits in the word.
+    template <std::size_t I>
+    static constexpr Word Encode(const Value<I> value) noexcept {
+        return static_cast<Word>(Field<I>::Encode(value) << offsets[I]);
+    }
+
+    template <std::size_t I, typename V, typename... Rest>
+    constexpr void Assign(const V value, const Rest... rest) noexcept {
+        Set<I>(value);
+        if constexpr (sizeof...(Rest) > 0) {
+            Assign<I + 1>(rest...);
+        }
+    }
+
+    Word word_ {0};
+};
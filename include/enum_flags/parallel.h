@@ -0,0 +1,57 @@
+/**
+ * @file parallel.h
+ * @brief Threading helpers shared by the @p EnumFlags extensions.
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+//! The assumed size of a cache line, used to pad data shared between threads.
+inline constexpr std::size_t cache_line_size {64};
+
+//! Get a small sequential index of the calling thread, assigned on first use.
+inline std::size_t ThreadIndex() noexcept {
+    static std::atomic_size_t next {0};
+    thread_local const auto index {next.fetch_add(1, std::memory_order_relaxed)};
+    return index;
+}
+
+//! Get the default number of threads for parallel algorithms.
+inline std::size_t DefaultThreadCount() noexcept {
+    return std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+}
+
+/**
+ * @brief Split the range <tt>[0, count)</tt> into contiguous parts and process them in parallel.
+ *
+ * @details
+ * The calling thread processes the last part.
+ *
+ * @param count The number of rows.
+ * @param func A function called with the beginning and end of each part.
+ * @param thread_count The maximum number of threads, including the calling thread.
+ * @param min_rows The minimum number of rows per part, so that small inputs stay serial.
+ */
+template <typename Func>
+void ParallelFor(const std::size_t count, Func&& func,
+                 const std::size_t thread_count = DefaultThreadCount(),
+                 const std::size_t min_rows = 4096) {
+    const auto parts {std::clamp<std::size_t>(count / std::max<std::size_t>(min_rows, 1), 1,
+                                              std::max<std::size_t>(thread_count, 1))};
+    const auto part_size {(count + parts - 1) / parts};
+    std::vector<std::jthread> threads;
+    threads.reserve(parts - 1);
+    for (std::size_t begin {0}; begin + part_size < count; begin += part_size) {
+        threads.emplace_back([&func, begin, part_size] { func(begin, begin + part_size); });
+    }
+
+    func(threads.size() * part_size, count);
+}
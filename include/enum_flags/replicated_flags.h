@@ -0,0 +1,138 @@
+/**
+ * @file replicated_flags.h
+ * @brief Read-mostly @p EnumFlags replicated per thread.
+ *
+ * @details
+ * Each replica sits on its own cache line, so readers on different cores never share a line.
+ * A read only loads the replica assigned to the calling thread.
+ * Writes are serialized and update every replica.
+ *
+ * Every replica pairs the flags with a generation counter, which is odd while a writer updates it.
+ * A reader retries when the generation is odd or changes during the read,
+ * and can compare generations to detect that it has observed a mid-update view across replicas.
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ */
+
+#pragma once
+
+#include "enum_flags.h"
+#include "parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+//! Read-mostly @p EnumFlags with a cache-line-padded replica per thread.
+template <typename Enum>
+class ReplicatedFlags {
+public:
+    using Flags = EnumFlags<Enum>;
+    using RawType = Flags::RawType;
+
+    //! Flags with the generation in which they were written.
+    struct Versioned {
+        Flags flags;
+
+        //! The number of writes applied to the replica.
+        std::uint64_t generation;
+    };
+
+    /**
+     * @brief Create flags.
+     *
+     * @param flags Initial flags.
+     * @param replica_count The number of replicas. Threads beyond it share replicas.
+     */
+    explicit ReplicatedFlags(const Flags flags = {},
+                             const std::size_t replica_count = DefaultThreadCount()) :
+        replicas_(std::max<std::size_t>(replica_count, 1)), flags_ {flags} {
+        for (auto& replica : replicas_) {
+            replica.flags.store(flags, std::memory_order_relaxed);
+        }
+    }
+
+    ReplicatedFlags(const ReplicatedFlags&) = delete;
+
+    ReplicatedFlags& operator=(const ReplicatedFlags&) = delete;
+
+    //! Get the flags and their generation from the replica of the calling thread.
+    Versioned LoadVersioned() const noexcept {
+        const auto& replica {replicas_[ThreadIndex() % replicas_.size()]};
+        for (;;) {
+            const auto generation {replica.generation.load(std::memory_order_acquire)};
+            if (generation % 2 == 0) {
+                const Flags flags {replica.flags.load(std::memory_order_relaxed)};
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (replica.generation.load(std::memory_order_relaxed) == generation) {
+                    return {flags, generation / 2};
+                }
+            }
+        }
+    }
+
+    //! Get the flags from the replica of the calling thread.
+    Flags Load() const noexcept {
+        return LoadVersioned().flags;
+    }
+
+    //! Check whether a flag is set.
+    bool Has(const Enum flag) const noexcept {
+        return Load().Has(flag);
+    }
+
+    //! Check whether all specific flags are set.
+    bool HasAll(const Flags flags) const noexcept {
+        return Load().HasAll(flags);
+    }
+
+    //! Check whether at least one of the specific flags is set.
+    bool HasAny(const Flags flags) const noexcept {
+        return Load().HasAny(flags);
+    }
+
+    //! Add specific flags to all replicas.
+    void Add(const Flags flags) {
+        Store([flags](Flags old) noexcept { return old.Add(flags); });
+    }
+
+    //! Remove specific flags from all replicas.
+    void Remove(const Flags flags) {
+        Store([flags](Flags old) noexcept { return old.Remove(flags); });
+    }
+
+    //! Reset all replicas to specific flags.
+    void Set(const Flags flags) {
+        Store([flags](Flags) noexcept { return flags; });
+    }
+
+private:
+    struct alignas(cache_line_size) Replica {
+        std::atomic<RawType> flags;
+        std::atomic_uint64_t generation {0};
+    };
+
+    template <typename Func>
+    void Store(Func&& func) {
+        const std::lock_guard lock {mtx_};
+        flags_ = func(flags_);
+        for (auto& replica : replicas_) {
+            const auto generation {replica.generation.load(std::memory_order_relaxed)};
+            replica.generation.store(generation + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            replica.flags.store(flags_, std::memory_order_relaxed);
+            replica.generation.store(generation + 2, std::memory_order_release);
+        }
+    }
+
+    std::vector<Replica> replicas_;
+
+    //! The authoritative flags, guarded by the writer lock.
+    Flags flags_;
+
+    std::mutex mtx_;
+};
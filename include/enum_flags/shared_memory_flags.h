@@ -0,0 +1,389 @@
+/**
+ * @file shared_memory_flags.h
+ * @brief Atomic @p EnumFlags in a POSIX shared-memory segment, with cross-process waiting.
+ *
+ * @details
+ * A segment starts with a header recording a fingerprint of the enumeration, the flag width
+ * and the number of words, so a process opening it with a different enumeration fails.
+ * An enumeration must declare a name in @ref EnumFlagsTraits to be shared:
+ *
+ * @code {.cpp}
+ * template <>
+ * struct EnumFlagsTraits<Status> {
+ *     static constexpr std::string_view name {"status"};
+ * };
+ * @endcode
+ *
+ * The fingerprint is a hash of the name and the valid flags,
+ * so processes built by different compilers can share a segment.
+ *
+ * Every word is paired with a 32-bit change sequence.
+ * Checking flags is a plain atomic load.
+ * Waiting for flags sleeps on the sequence with a shared Linux futex,
+ * and writers only make a system call when another process is waiting.
+ *
+ * It is available on Linux only.
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ */
+
+#pragma once
+
+#include "enum_flags.h"
+
+#if defined(__linux__)
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <expected>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+//! An array of atomic @p EnumFlags in a POSIX shared-memory segment.
+template <typename Enum>
+class SharedFlagsSegment {
+public:
+    using Flags = EnumFlags<Enum>;
+    using RawType = Flags::RawType;
+
+    static_assert(std::atomic<RawType>::is_always_lock_free
+                      && std::atomic_uint32_t::is_always_lock_free,
+                  "Atomic words must be lock-free to be shared between processes.");
+
+    static_assert(requires { std::string_view {EnumFlagsTraits<Enum>::name}; },
+                  "An enumeration shared between processes must declare a unique `name` "
+                  "in `EnumFlagsTraits`.");
+
+    //! The version of the segment layout.
+    static constexpr std::uint32_t layout_version {1};
+
+    /**
+     * @brief Create a new segment with empty flags.
+     *
+     * @param name A POSIX shared-memory name, such as @p "/status".
+     * @param count The number of flag words.
+     * @return The segment, or an error if it already exists or cannot be created.
+     */
+    static std::expected<SharedFlagsSegment, std::error_code> Create(const std::string& name,
+                                                                     const std::size_t count) {
+        const auto fd {shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600)};
+        if (fd == -1) {
+            return std::unexpected {LastError()};
+        }
+
+        const auto bytes {sizeof(Header) + count * sizeof(Slot)};
+        if (ftruncate(fd, static_cast<off_t>(bytes)) == -1) {
+            const auto error {LastError()};
+            close(fd);
+            shm_unlink(name.c_str());
+            return std::unexpected {error};
+        }
+
+        auto segment {Map(fd, bytes)};
+        if (!segment) {
+            shm_unlink(name.c_str());
+            return segment;
+        }
+
+        // A newly truncated segment is zero-filled, which is a valid state for atomics.
+        auto& header {segment->GetHeader()};
+        header.magic = magic;
+        header.version = layout_version;
+        header.enum_id = EnumId();
+        header.width = sizeof(RawType);
+        header.count = count;
+        header.ready.store(1, std::memory_order_release);
+        return segment;
+    }
+
+    /**
+     * @brief Open an existing segment.
+     *
+     * @return The segment, or an error if it cannot be opened.
+     * If it is still being created, the error is @p std::errc::resource_unavailable_try_again.
+     * If its header does not match the enumeration, the error is @p std::errc::invalid_argument.
+     */
+    static std::expected<SharedFlagsSegment, std::error_code> Open(const std::string& name) {
+        const auto fd {shm_open(name.c_str(), O_RDWR, 0)};
+        if (fd == -1) {
+            return std::unexpected {LastError()};
+        }
+
+        struct stat info {};
+        if (fstat(fd, &info) == -1) {
+            const auto error {LastError()};
+            close(fd);
+            return std::unexpected {error};
+        }
+
+        // A segment is resized and then has its header written after its name appears.
+        const auto bytes {static_cast<std::size_t>(info.st_size)};
+        if (bytes < sizeof(Header)) {
+            close(fd);
+            return std::unexpected {
+                std::make_error_code(std::errc::resource_unavailable_try_again)};
+        }
+
+        auto segment {Map(fd, bytes)};
+        if (!segment) {
+            return segment;
+        }
+
+        const auto& header {segment->GetHeader()};
+        if (header.ready.load(std::memory_order_acquire) != 1) {
+            return std::unexpected {
+                std::make_error_code(std::errc::resource_unavailable_try_again)};
+        }
+
+        if (header.magic != magic || header.version != layout_version || header.enum_id != EnumId()
+            || header.width != sizeof(RawType)
+            || bytes < sizeof(Header) + header.count * sizeof(Slot)) {
+            return std::unexpected {std::make_error_code(std::errc::invalid_argument)};
+        }
+
+        return segment;
+    }
+
+    //! Remove a segment name. Mapped segments stay valid until they are closed.
+    static std::error_code Unlink(const std::string& name) noexcept {
+        return shm_unlink(name.c_str()) == -1 ? LastError() : std::error_code {};
+    }
+
+    SharedFlagsSegment(SharedFlagsSegment&& o) noexcept :
+        data_ {std::exchange(o.data_, nullptr)}, bytes_ {std::exchange(o.bytes_, 0)} {}
+
+    SharedFlagsSegment& operator=(SharedFlagsSegment&& o) noexcept {
+        if (this != &o) {
+            Unmap();
+            data_ = std::exchange(o.data_, nullptr);
+            bytes_ = std::exchange(o.bytes_, 0);
+        }
+
+        return *this;
+    }
+
+    //! Unmap the segment.
+    ~SharedFlagsSegment() noexcept {
+        Unmap();
+    }
+
+    //! Get the number of flag words.
+    std::size_t Size() const noexcept {
+        return static_cast<std::size_t>(GetHeader().count);
+    }
+
+    //! Load a word.
+    Flags Load(const std::size_t i) const noexcept {
+        return SlotAt(i).flags.load(std::memory_order_acquire);
+    }
+
+    //! Check whether a flag is set in a word.
+    bool Has(const std::size_t i, const Enum flag) const noexcept {
+        return Load(i).Has(flag);
+    }
+
+    //! Check whether all specific flags are set in a word.
+    bool HasAll(const std::size_t i, const Flags flags) const noexcept {
+        return Load(i).HasAll(flags);
+    }
+
+    //! Check whether at least one of the specific flags is set in a word.
+    bool HasAny(const std::size_t i, const Flags flags) const noexcept {
+        return Load(i).HasAny(flags);
+    }
+
+    //! Add specific flags to a word, waking up waiting processes, and get its previous flags.
+    Flags Add(const std::size_t i, const Flags flags) noexcept {
+        auto& slot {SlotAt(i)};
+        const Flags old {slot.flags.fetch_or(flags, std::memory_order_acq_rel)};
+        Notify(slot);
+        return old;
+    }
+
+    //! Remove specific flags from a word, waking up waiting processes, and get its previous flags.
+    Flags Remove(const std::size_t i, const Flags flags) noexcept {
+        auto& slot {SlotAt(i)};
+        const Flags old {slot.flags.fetch_and(static_cast<RawType>(~static_cast<RawType>(flags)),
+                                              std::memory_order_acq_rel)};
+        Notify(slot);
+        return old;
+    }
+
+    //! Reset a word to specific flags, waking up waiting processes.
+    void Store(const std::size_t i, const Flags flags) noexcept {
+        auto& slot {SlotAt(i)};
+        slot.flags.store(flags, std::memory_order_release);
+        Notify(slot);
+    }
+
+    //! Wait until at least one of the specific flags is set in a word, and get the word.
+    Flags WaitAny(const std::size_t i, const Flags flags) const noexcept {
+        return *Wait(i, [flags](const Flags f) noexcept { return f.HasAny(flags); }, nullptr);
+    }
+
+    //! Wait until all specific flags are set in a word, and get the word.
+    Flags WaitAll(const std::size_t i, const Flags flags) const noexcept {
+        return *Wait(i, [flags](const Flags f) noexcept { return f.HasAll(flags); }, nullptr);
+    }
+
+    /**
+     * @brief Wait until at least one of the specific flags is set in a word, or a timeout expires.
+     *
+     * @return The word, or nothing if the timeout has expired.
+     */
+    std::optional<Flags> WaitAny(const std::size_t i, const Flags flags,
+                                 const std::chrono::nanoseconds timeout) const noexcept {
+        const auto deadline {std::chrono::steady_clock::now() + timeout};
+        return Wait(i, [flags](const Flags f) noexcept { return f.HasAny(flags); }, &deadline);
+    }
+
+    /**
+     * @brief Wait until all specific flags are set in a word, or a timeout expires.
+     *
+     * @return The word, or nothing if the timeout has expired.
+     */
+    std::optional<Flags> WaitAll(const std::size_t i, const Flags flags,
+                                 const std::chrono::nanoseconds timeout) const noexcept {
+        const auto deadline {std::chrono::steady_clock::now() + timeout};
+        return Wait(i, [flags](const Flags f) noexcept { return f.HasAll(flags); }, &deadline);
+    }
+
+private:
+    static constexpr std::uint32_t magic {0x4546'534D};
+
+    struct Header {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint64_t enum_id;
+        std::uint32_t width;
+
+        //! Set after the rest of the header has been written.
+        std::atomic_uint32_t ready;
+
+        std::uint64_t count;
+    };
+
+    struct Slot {
+        std::atomic<RawType> flags;
+
+        //! Incremented after every change, as the futex word.
+        std::atomic_uint32_t seq;
+
+        std::atomic_uint32_t waiters;
+    };
+
+    SharedFlagsSegment(void* const data, const std::size_t bytes) noexcept :
+        data_ {data}, bytes_ {bytes} {}
+
+    static std::error_code LastError() noexcept {
+        return {errno, std::system_category()};
+    }
+
+    //! Map a shared-memory file and close its descriptor.
+    static std::expected<SharedFlagsSegment, std::error_code> Map(const int fd,
+                                                                  const std::size_t bytes) {
+        const auto data {mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)};
+        const auto error {LastError()};
+        close(fd);
+        if (data == MAP_FAILED) {
+            return std::unexpected {error};
+        }
+
+        return SharedFlagsSegment {data, bytes};
+    }
+
+    //! Identify the enumeration by an FNV-1a hash of its declared name and valid flags.
+    static constexpr std::uint64_t EnumId() noexcept {
+        constexpr std::uint64_t prime {0x100000001B3};
+        std::uint64_t hash {0xCBF29CE484222325};
+        for (const auto c : std::string_view {EnumFlagsTraits<Enum>::name}) {
+            hash = (hash ^ static_cast<unsigned char>(c)) * prime;
+        }
+
+        auto mask {static_cast<std::uint64_t>(FlagTraits<Enum>::valid_mask)};
+        for (std::size_t i {0}; i != sizeof(mask); ++i, mask >>= CHAR_BIT) {
+            hash = (hash ^ (mask & 0xFF)) * prime;
+        }
+
+        return hash;
+    }
+
+    static void Notify(Slot& slot) noexcept {
+        // Both sides store and then load the other's word, which needs sequential consistency.
+        // Otherwise a writer may miss a new waiter while the waiter misses the new sequence.
+        slot.seq.fetch_add(1, std::memory_order_seq_cst);
+        if (slot.waiters.load(std::memory_order_seq_cst) != 0) {
+            syscall(SYS_futex, &slot.seq, FUTEX_WAKE, INT32_MAX, nullptr, nullptr, 0);
+        }
+    }
+
+    template <typename Pred>
+    std::optional<Flags> Wait(const std::size_t i, Pred&& pred,
+                              const std::chrono::steady_clock::time_point* const deadline)
+        const noexcept {
+        auto& slot {const_cast<Slot&>(SlotAt(i))};
+        for (;;) {
+            const auto seq {slot.seq.load(std::memory_order_acquire)};
+            if (const Flags flags {slot.flags.load(std::memory_order_acquire)}; pred(flags)) {
+                return flags;
+            }
+
+            timespec timeout {};
+            if (deadline != nullptr) {
+                const auto left {*deadline - std::chrono::steady_clock::now()};
+                if (left <= std::chrono::nanoseconds::zero()) {
+                    return std::nullopt;
+                }
+
+                const auto ns {std::chrono::duration_cast<std::chrono::nanoseconds>(left).count()};
+                timeout.tv_sec = static_cast<std::time_t>(ns / 1'000'000'000);
+                timeout.tv_nsec = static_cast<long>(ns % 1'000'000'000);
+            }
+
+            // Sleep only if no change has happened since the sequence was loaded.
+            slot.waiters.fetch_add(1, std::memory_order_seq_cst);
+            if (slot.seq.load(std::memory_order_seq_cst) == seq) {
+                syscall(SYS_futex, &slot.seq, FUTEX_WAIT, seq,
+                        deadline != nullptr ? &timeout : nullptr, nullptr, 0);
+            }
+
+            slot.waiters.fetch_sub(1, std::memory_order_acq_rel);
+        }
+    }
+
+    void Unmap() noexcept {
+        if (data_ != nullptr) {
+            munmap(data_, bytes_);
+            data_ = nullptr;
+        }
+    }
+
+    Header& GetHeader() const noexcept {
+        return *static_cast<Header*>(data_);
+    }
+
+    Slot& SlotAt(const std::size_t i) const noexcept {
+        return reinterpret_cast<Slot*>(static_cast<std::byte*>(data_) + sizeof(Header))[i];
+    }
+
+    void* data_;
+    std::size_t bytes_;
+};
+
+#endif
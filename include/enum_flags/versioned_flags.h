@@ -0,0 +1,156 @@
+/**
+ * @file versioned_flags.h
+ * @brief Atomic @p EnumFlags packed with a version counter for ABA-free updates.
+ *
+ * @details
+ * Every successful update increments the version, so a compare-exchange fails
+ * if the flags have changed in between, even if they have changed back to the expected value.
+ *
+ * Flags of up to 32 bits share a 64-bit word with the version.
+ * Wider flags use a 128-bit word with a 64-bit version,
+ * which needs a double-width compare-exchange such as @p cmpxchg16b.
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ */
+
+#pragma once
+
+#include "enum_flags.h"
+
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <thread>
+#include <type_traits>
+
+//! Atomic @p EnumFlags packed with a version counter.
+template <typename Enum>
+class VersionedEnumFlags {
+public:
+    using Flags = EnumFlags<Enum>;
+    using RawType = Flags::RawType;
+
+    //! Flags with their version.
+    struct Versioned {
+        Flags flags;
+        std::uint64_t version;
+
+        constexpr bool operator==(const Versioned&) const noexcept = default;
+    };
+
+    //! The number of bits of the version, after which it wraps around.
+    static constexpr std::size_t version_bits {
+        sizeof(RawType) <= sizeof(std::uint32_t)
+            ? std::numeric_limits<std::uint64_t>::digits - std::numeric_limits<RawType>::digits
+            : std::numeric_limits<std::uint64_t>::digits};
+
+    //! Create flags with version zero.
+    explicit VersionedEnumFlags(const Flags flags = {}) noexcept : word_ {Pack({flags, 0})} {}
+
+    VersionedEnumFlags(const VersionedEnumFlags&) = delete;
+
+    VersionedEnumFlags& operator=(const VersionedEnumFlags&) = delete;
+
+    //! Check whether the packed word is updated without locks.
+    bool IsLockFree() const noexcept {
+        return word_.is_lock_free();
+    }
+
+    //! Get the flags and their version.
+    Versioned Load(const std::memory_order order = std::memory_order_seq_cst) const noexcept {
+        return Unpack(word_.load(order));
+    }
+
+    /**
+     * @brief Replace the flags if neither they nor their version have changed.
+     *
+     * @param expected The expected flags and version.
+     * On failure, it is updated to the current flags and version.
+     * On success, it is updated to the new flags and version.
+     * @param desired New flags.
+     * @return Whether the flags have been replaced.
+     */
+    bool CompareExchange(Versioned& expected, const Flags desired) noexcept {
+        auto old {Pack(expected)};
+        const Versioned next {desired, (expected.version + 1) & version_mask};
+        if (word_.compare_exchange_strong(old, Pack(next), std::memory_order_acq_rel,
+                                          std::memory_order_acquire)) {
+            expected = next;
+            return true;
+        } else {
+            expected = Unpack(old);
+            return false;
+        }
+    }
+
+    /**
+     * @brief Update the flags with a function until no other update interferes.
+     *
+     * @details
+     * After a failed attempt, it backs off for an exponentially growing time before retrying.
+     *
+     * @param func A function computing new flags from the current ones.
+     * It may be called several times.
+     * @return The new flags and version.
+     */
+    template <std::invocable<Flags> Func>
+    Versioned Update(Func&& func) {
+        auto expected {Load(std::memory_order_acquire)};
+        for (std::size_t spins {1};; spins = std::min(spins * 2, max_spins)) {
+            if (CompareExchange(expected, func(expected.flags))) {
+                return expected;
+            }
+
+            for (std::size_t i {0}; i != spins; ++i) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    //! Add specific flags.
+    Versioned Add(const Flags flags) noexcept {
+        return Update([flags](Flags old) noexcept { return old.Add(flags); });
+    }
+
+    //! Remove specific flags.
+    Versioned Remove(const Flags flags) noexcept {
+        return Update([flags](Flags old) noexcept { return old.Remove(flags); });
+    }
+
+private:
+    static constexpr std::size_t max_spins {64};
+
+    static constexpr std::uint64_t version_mask {
+        version_bits == std::numeric_limits<std::uint64_t>::digits
+            ? std::numeric_limits<std::uint64_t>::max()
+            : (std::uint64_t {1} << version_bits) - 1};
+
+    struct alignas(2 * sizeof(std::uint64_t)) Wide {
+        std::uint64_t flags;
+        std::uint64_t version;
+    };
+
+    using Word = std::conditional_t<sizeof(RawType) <= sizeof(std::uint32_t), std::uint64_t, Wide>;
+
+    static constexpr Word Pack(const Versioned& value) noexcept {
+        if constexpr (std::is_same_v<Word, Wide>) {
+            return {static_cast<RawType>(value.flags), value.version};
+        } else {
+            return static_cast<RawType>(value.flags) | value.version << (64 - version_bits);
+        }
+    }
+
+    static constexpr Versioned Unpack(const Word word) noexcept {
+        if constexpr (std::is_same_v<Word, Wide>) {
+            return {static_cast<RawType>(word.flags), word.version};
+        } else {
+            return {static_cast<RawType>(word), word >> (64 - version_bits)};
+        }
+    }
+
+    std::atomic<Word> word_;
+};
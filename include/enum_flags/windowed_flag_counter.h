@@ -0,0 +1,248 @@
+/**
+ * @file windowed_flag_counter.h
+ * @brief Per-flag counts of @p EnumFlags events over a sliding window.
+ *
+ * @details
+ * The window is split into a ring of buckets, each holding per-flag counts of its events.
+ * A window is either time-based or count-based.
+ * When the window slides, the oldest buckets are evicted as a whole.
+ * Inserting an event and evicting a bucket only visit the set bits.
+ *
+ * A counter has a single writer.
+ * Other threads can take consistent snapshots of the totals without locking.
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ */
+
+#pragma once
+
+#include "enum_flags.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+//! Per-flag counts of events over a sliding window.
+template <typename Enum, typename Clock = std::chrono::steady_clock>
+class WindowedFlagCounter {
+public:
+    using Flags = EnumFlags<Enum>;
+    using RawType = Flags::RawType;
+
+    //! The number of bits up to the highest valid flag.
+    static constexpr std::size_t bit_count {FlagTraits<Enum>::bit_width};
+
+    //! A consistent view of the counts in a window.
+    class Snapshot {
+    public:
+        //! Get the number of events.
+        std::uint64_t Events() const noexcept {
+            return events_;
+        }
+
+        //! Get the number of events having a flag set.
+        std::uint64_t Count(const Enum flag) const noexcept {
+            return counts_[BitOf(flag)];
+        }
+
+        //! Get the proportion of events having a flag set, or zero if there are no events.
+        double Ratio(const Enum flag) const noexcept {
+            return events_ == 0 ? 0.0
+                                : static_cast<double>(Count(flag)) / static_cast<double>(events_);
+        }
+
+    private:
+        friend class WindowedFlagCounter;
+
+        std::uint64_t events_ {0};
+        std::array<std::uint64_t, bit_count> counts_ {};
+    };
+
+    /**
+     * @brief Create a time-based window.
+     *
+     * @param window The length of the window.
+     * @param bucket_count The number of buckets. Events expire a bucket at a time.
+     */
+    WindowedFlagCounter(const typename Clock::duration window, const std::size_t bucket_count) :
+        buckets_(std::max<std::size_t>(bucket_count, 1)),
+        width_ {std::max<std::uint64_t>(
+            static_cast<std::uint64_t>(window.count()) / buckets_.size(), 1)},
+        by_count_ {false} {}
+
+    /**
+     * @brief Create a count-based window.
+     *
+     * @param event_count The number of latest events in the window.
+     * @param bucket_count The number of buckets. Events expire a bucket at a time.
+     */
+    WindowedFlagCounter(const std::size_t event_count, const std::size_t bucket_count) :
+        buckets_(std::max<std::size_t>(bucket_count, 1)),
+        width_ {std::max<std::uint64_t>((event_count + buckets_.size() - 1) / buckets_.size(), 1)},
+        by_count_ {true} {}
+
+    WindowedFlagCounter(const WindowedFlagCounter&) = delete;
+
+    WindowedFlagCounter& operator=(const WindowedFlagCounter&) = delete;
+
+    /**
+     * @brief Insert an event.
+     *
+     * @details
+     * A time-based window uses the current time of the clock.
+     * Bits that are not valid flags are ignored.
+     */
+    void Insert(const Flags flags) noexcept {
+        if (by_count_) {
+            Insert(flags, inserted_ / width_);
+        } else {
+            Insert(flags, Clock::now());
+        }
+    }
+
+    /**
+     * @brief Insert an event occurring at a specific time into a time-based window.
+     *
+     * @details
+     * Events older than the window are ignored.
+     */
+    void Insert(const Flags flags, const typename Clock::time_point time) noexcept {
+        Insert(flags, PositionOf(time));
+    }
+
+    //! Slide a time-based window to a specific time, evicting expired events.
+    void Advance(const typename Clock::time_point time) noexcept {
+        BeginWrite();
+        Rotate(PositionOf(time));
+        EndWrite();
+    }
+
+    //! Get the number of events having a flag set, from the writer thread.
+    std::uint64_t Count(const Enum flag) const noexcept {
+        return counts_[BitOf(flag)].load(std::memory_order_relaxed);
+    }
+
+    //! Get the number of events, from the writer thread.
+    std::uint64_t Events() const noexcept {
+        return events_.load(std::memory_order_relaxed);
+    }
+
+    //! Take a consistent snapshot of the counts without blocking the writer.
+    Snapshot Read() const noexcept {
+        Snapshot snapshot;
+        for (;;) {
+            const auto seq {seq_.load(std::memory_order_acquire)};
+            if (seq % 2 != 0) {
+                continue;
+            }
+
+            snapshot.events_ = events_.load(std::memory_order_relaxed);
+            for (std::size_t i {0}; i != bit_count; ++i) {
+                snapshot.counts_[i] = counts_[i].load(std::memory_order_relaxed);
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seq_.load(std::memory_order_relaxed) == seq) {
+                return snapshot;
+            }
+        }
+    }
+
+private:
+    struct Bucket {
+        std::uint64_t events {0};
+        Flags seen;
+        std::array<std::uint64_t, bit_count> counts {};
+    };
+
+    static std::size_t BitOf(const Enum flag) noexcept {
+        return static_cast<std::size_t>(std::countr_zero(std::to_underlying(flag)));
+    }
+
+    std::uint64_t PositionOf(const typename Clock::time_point time) const noexcept {
+        return static_cast<std::uint64_t>(time.time_since_epoch().count()) / width_;
+    }
+
+    void Insert(const Flags flags, const std::uint64_t pos) noexcept {
+        BeginWrite();
+        Rotate(pos);
+        if (head_ - pos < buckets_.size()) {
+            auto& bucket {buckets_[pos % buckets_.size()]};
+            const auto valid {Flags {flags}.Sanitize()};
+            valid.ForEachBit([this, &bucket](const std::size_t bit) noexcept {
+                ++bucket.counts[bit];
+                counts_[bit].store(counts_[bit].load(std::memory_order_relaxed) + 1,
+                                   std::memory_order_relaxed);
+            });
+
+            bucket.seen |= valid;
+            ++bucket.events;
+            events_.store(events_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+
+        ++inserted_;
+        EndWrite();
+    }
+
+    //! Move the head of the window to a position, evicting the buckets leaving the window.
+    void Rotate(const std::uint64_t pos) noexcept {
+        if (pos <= head_) {
+            return;
+        }
+
+        const auto size {buckets_.size()};
+        // Positions older than the last `size` ones map to the same buckets and need no visit.
+        for (auto p {std::max(head_ + 1, pos >= size ? pos - size + 1 : 0)}; p <= pos; ++p) {
+            Evict(buckets_[p % size]);
+        }
+
+        head_ = pos;
+    }
+
+    void Evict(Bucket& bucket) noexcept {
+        bucket.seen.ForEachBit([this, &bucket](const std::size_t bit) noexcept {
+            counts_[bit].store(counts_[bit].load(std::memory_order_relaxed) - bucket.counts[bit],
+                               std::memory_order_relaxed);
+            bucket.counts[bit] = 0;
+        });
+
+        events_.store(events_.load(std::memory_order_relaxed) - bucket.events,
+                      std::memory_order_relaxed);
+        bucket.events = 0;
+        bucket.seen.Clear();
+    }
+
+    void BeginWrite() noexcept {
+        seq_.store(seq_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    void EndWrite() noexcept {
+        seq_.store(seq_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    std::vector<Bucket> buckets_;
+
+    //! The number of clock ticks or events covered by a bucket.
+    std::uint64_t width_;
+
+    bool by_count_;
+
+    //! The position of the newest bucket.
+    std::uint64_t head_ {0};
+
+    std::uint64_t inserted_ {0};
+
+    //! A sequence lock: odd while the writer is updating the totals.
+    std::atomic_uint64_t seq_ {0};
+
+    std::atomic_uint64_t events_ {0};
+    std::array<std::atomic_uint64_t, bit_count> counts_ {};
+};
@@ -0,0 +1,94 @@
+#include "enum_flags/atomic_flags_array.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace {
+
+enum class Opt : std::uint32_t {
+    A = EnumFlags<Opt>::CreateFlag(0),
+    B = EnumFlags<Opt>::CreateFlag(1),
+    C = EnumFlags<Opt>::CreateFlag(2)
+};
+
+template <typename T>
+class TypedAtomicFlagsArray : public testing::Test {};
+
+using Layouts = testing::Types<DenseLayout, PaddedLayout, GroupedLayout<4>>;
+
+std::uintptr_t AddressOf(const void* const p) {
+    return reinterpret_cast<std::uintptr_t>(p);
+}
+
+}  // namespace
+
+TYPED_TEST_SUITE(TypedAtomicFlagsArray, Layouts);
+
+TYPED_TEST(TypedAtomicFlagsArray, ElementOperations) {
+    AtomicFlagsArray<Opt, TypeParam> array {37};
+    EXPECT_EQ(array.Size(), 37);
+    EXPECT_EQ(array.Load(36), EnumFlags<Opt> {});
+
+    EXPECT_EQ(array.Add(5, {Opt::A, Opt::B}), EnumFlags<Opt> {});
+    EXPECT_EQ(array.Remove(5, Opt::A), (EnumFlags<Opt> {Opt::A, Opt::B}));
+    EXPECT_EQ(array.Load(5), Opt::B);
+
+    array.Store(6, Opt::C);
+    EXPECT_EQ(array[6].load(), std::to_underlying(Opt::C));
+}
+
+TYPED_TEST(TypedAtomicFlagsArray, BulkOperations) {
+    AtomicFlagsArray<Opt, TypeParam> array {37};
+    EXPECT_FALSE(array.FindFirstAny(Opt::A).has_value());
+
+    array.Add(20, {Opt::A, Opt::C});
+    array.Add(30, Opt::A);
+    EXPECT_EQ(array.FindFirstAny({Opt::A, Opt::B}), 20);
+    EXPECT_EQ(array.FindFirstAll({Opt::A, Opt::C}), 20);
+
+    array.AddAll(Opt::B);
+    EXPECT_EQ(array.FindFirstAll({Opt::A, Opt::B}), 20);
+    for (std::size_t i {0}; i != array.Size(); ++i) {
+        EXPECT_TRUE(array.Load(i).Has(Opt::B));
+    }
+
+    array.RemoveAll({Opt::A, Opt::B});
+    EXPECT_EQ(array.FindFirstAny({Opt::A, Opt::B}), std::nullopt);
+    EXPECT_EQ(array.FindFirstAny(Opt::C), 20);
+}
+
+TEST(AtomicFlagsArray, Layouts) {
+    constexpr std::size_t size {64};
+
+    const AtomicFlagsArray<Opt, DenseLayout> dense {size};
+    EXPECT_EQ(dense.MemoryBytes(), size * sizeof(std::uint32_t));
+    EXPECT_EQ(AddressOf(&dense[1]) - AddressOf(&dense[0]), sizeof(std::uint32_t));
+
+    const AtomicFlagsArray<Opt, PaddedLayout> padded {size};
+    EXPECT_EQ(padded.MemoryBytes(), size * cache_line_size);
+    EXPECT_EQ(AddressOf(&padded[1]) - AddressOf(&padded[0]), cache_line_size);
+
+    const AtomicFlagsArray<Opt, GroupedLayout<4>> grouped {size};
+    EXPECT_EQ(grouped.MemoryBytes(), size / 4 * cache_line_size);
+    EXPECT_EQ(AddressOf(&grouped[3]) / cache_line_size, AddressOf(&grouped[0]) / cache_line_size);
+    EXPECT_EQ(AddressOf(&grouped[4]) - AddressOf(&grouped[0]), cache_line_size);
+}
+
+TEST(AtomicFlagsArray, ConcurrentBulkAdd) {
+    AtomicFlagsArray<Opt, GroupedLayout<2>> array {100};
+    std::vector<std::thread> threads;
+    for (const auto opt : {Opt::A, Opt::B, Opt::C}) {
+        threads.emplace_back([&array, opt] { array.AddAll(opt); });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (std::size_t i {0}; i != array.Size(); ++i) {
+        EXPECT_TRUE(array.Load(i).HasAll({Opt::A, Opt::B, Opt::C}));
+    }
+}
@@ -0,0 +1,148 @@
+#include "enum_flags/awaitable_flags.h"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace {
+
+enum class Opt : unsigned int {
+    A = EnumFlags<Opt>::CreateFlag(0),
+    B = EnumFlags<Opt>::CreateFlag(1),
+    C = EnumFlags<Opt>::CreateFlag(2),
+    D = EnumFlags<Opt>::CreateFlag(3)
+};
+
+SerialExecutor::Task WaitAll(AwaitableFlags<Opt>& flags, const EnumFlags<Opt> mask,
+                             std::vector<EnumFlags<Opt>>& results) {
+    results.push_back(co_await flags.WhenAll(mask));
+}
+
+SerialExecutor::Task WaitAny(AwaitableFlags<Opt>& flags, const EnumFlags<Opt> mask,
+                             std::vector<EnumFlags<Opt>>& results) {
+    results.push_back(co_await flags.WhenAny(mask));
+}
+
+}  // namespace
+
+TEST(AwaitableFlags, ReadyWithoutSuspending) {
+    SerialExecutor executor;
+    AwaitableFlags<Opt> flags {{Opt::A, Opt::B}, &executor};
+    std::vector<EnumFlags<Opt>> results;
+    executor.Spawn(WaitAll(flags, {Opt::A, Opt::B}, results));
+    executor.Spawn(WaitAny(flags, {Opt::B, Opt::C}, results));
+    executor.Spawn(WaitAll(flags, {}, results));
+    EXPECT_EQ(executor.Run(), 3);
+    EXPECT_EQ(flags.Waiters(), 0);
+    ASSERT_EQ(results.size(), 3);
+    EXPECT_EQ(results[0], (EnumFlags<Opt> {Opt::A, Opt::B}));
+}
+
+TEST(AwaitableFlags, WhenAll) {
+    SerialExecutor executor;
+    AwaitableFlags<Opt> flags {{}, &executor};
+    std::vector<EnumFlags<Opt>> results;
+    executor.Spawn(WaitAll(flags, {Opt::A, Opt::B, Opt::C}, results));
+    EXPECT_EQ(executor.Run(), 1);
+    EXPECT_EQ(flags.Waiters(), 1);
+
+    flags.Add(Opt::A);
+    flags.Add({Opt::B, Opt::D});
+    EXPECT_EQ(executor.Pending(), 0);
+
+    // A falling edge never resumes waiters.
+    flags.Remove(Opt::A);
+    flags.Add(Opt::C);
+    EXPECT_EQ(executor.Pending(), 0);
+    EXPECT_TRUE(results.empty());
+
+    flags.Add(Opt::A);
+    EXPECT_EQ(executor.Pending(), 1);
+    EXPECT_EQ(flags.Waiters(), 0);
+    EXPECT_EQ(executor.Run(), 1);
+    ASSERT_EQ(results.size(), 1);
+    EXPECT_EQ(results.front(), (EnumFlags<Opt> {Opt::A, Opt::B, Opt::C, Opt::D}));
+}
+
+TEST(AwaitableFlags, WhenAnyResumesOnlyAffectedWaiters) {
+    SerialExecutor executor;
+    AwaitableFlags<Opt> flags {{}, &executor};
+    std::vector<EnumFlags<Opt>> results;
+    executor.Spawn(WaitAny(flags, {Opt::A, Opt::B}, results));
+    executor.Spawn(WaitAny(flags, {Opt::B, Opt::C}, results));
+    executor.Spawn(WaitAny(flags, Opt::D, results));
+    executor.Spawn(WaitAny(flags, {}, results));
+    executor.Run();
+    EXPECT_EQ(flags.Waiters(), 4);
+
+    flags.Add(Opt::C);
+    EXPECT_EQ(executor.Run(), 1);
+    EXPECT_EQ(flags.Waiters(), 3);
+    ASSERT_EQ(results.size(), 1);
+    EXPECT_EQ(results.back(), Opt::C);
+
+    flags.Add({Opt::A, Opt::B});
+    EXPECT_EQ(executor.Run(), 1);
+    EXPECT_EQ(flags.Waiters(), 2);
+
+    flags.Set(Opt::D);
+    EXPECT_EQ(executor.Run(), 1);
+    EXPECT_EQ(flags.Waiters(), 1);
+    EXPECT_EQ(results.size(), 3);
+}
+
+TEST(AwaitableFlags, ResumeInline) {
+    AwaitableFlags<Opt> flags;
+    std::vector<EnumFlags<Opt>> results;
+    auto first {WaitAll(flags, {Opt::A, Opt::B}, results)};
+    auto second {WaitAny(flags, {Opt::A, Opt::B}, results)};
+
+    SerialExecutor executor;
+    executor.Spawn(std::move(first));
+    executor.Spawn(std::move(second));
+    executor.Run();
+    EXPECT_EQ(flags.Waiters(), 2);
+
+    flags.Add(Opt::B);
+    EXPECT_EQ(results.size(), 1);
+    flags.Add(Opt::A);
+    EXPECT_EQ(results.size(), 2);
+    EXPECT_EQ(flags.Waiters(), 0);
+}
+
+TEST(AwaitableFlags, DestroySuspendedCoroutine) {
+    AwaitableFlags<Opt> flags;
+    std::vector<EnumFlags<Opt>> results;
+    {
+        SerialExecutor executor;
+        executor.Spawn(WaitAny(flags, {Opt::A, Opt::B}, results));
+        executor.Run();
+        EXPECT_EQ(flags.Waiters(), 1);
+    }
+
+    EXPECT_EQ(flags.Waiters(), 0);
+    flags.Add({Opt::A, Opt::B});
+    EXPECT_TRUE(results.empty());
+}
+
+TEST(AwaitableFlags, ReleaseFinishedTasks) {
+    AwaitableFlags<Opt> flags;
+    std::vector<EnumFlags<Opt>> results;
+    SerialExecutor executor;
+    executor.Spawn(WaitAny(flags, Opt::A, results));
+    executor.Spawn(WaitAll(flags, {Opt::A, Opt::B}, results));
+    executor.Spawn(WaitAny(flags, {Opt::A, Opt::C}, results));
+    executor.Spawn(WaitAll(flags, {}, results));
+    EXPECT_EQ(executor.Active(), 4);
+
+    // A task that does not suspend is released as soon as it runs.
+    executor.Run();
+    EXPECT_EQ(executor.Active(), 3);
+
+    // Tasks resumed inline by one mutation finish and are released one after another.
+    flags.Add({Opt::A, Opt::B});
+    EXPECT_EQ(results.size(), 4);
+    EXPECT_EQ(executor.Active(), 0);
+    EXPECT_EQ(flags.Waiters(), 0);
+}
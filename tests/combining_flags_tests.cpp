@@ -0,0 +1,58 @@
+#include "enum_flags/combining_flags.h"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+namespace {
+
+enum class Opt : unsigned int {
+    A = EnumFlags<Opt>::CreateFlag(0),
+    B = EnumFlags<Opt>::CreateFlag(1),
+    C = EnumFlags<Opt>::CreateFlag(2)
+};
+
+}  // namespace
+
+TEST(CombiningAtomicFlags, AddAndRemove) {
+    CombiningAtomicFlags<Opt> flags {Opt::A};
+    EXPECT_TRUE(flags.Has(Opt::A));
+
+    flags.Add({Opt::B, Opt::C});
+    EXPECT_TRUE(flags.HasAll({Opt::A, Opt::B, Opt::C}));
+
+    flags.Remove({Opt::A, Opt::B});
+    EXPECT_EQ(flags.Load(), Opt::C);
+    EXPECT_FALSE(flags.HasAny({Opt::A, Opt::B}));
+
+    flags.Update(Opt::A, {Opt::A, Opt::C});
+    EXPECT_EQ(flags.Load(), Opt::A);
+}
+
+TEST(CombiningAtomicFlags, ConcurrentUpdates) {
+    constexpr std::size_t thread_count {8};
+    constexpr std::size_t iterations {2000};
+
+    // Each thread owns one bit, toggles it many times and finally leaves it set.
+    CombiningAtomicFlags<Opt> flags {{}, 4};
+    std::vector<std::thread> threads;
+    for (std::size_t t {0}; t != thread_count; ++t) {
+        threads.emplace_back([&flags, t] {
+            const EnumFlags<Opt> bit {1U << t};
+            for (std::size_t i {0}; i != iterations; ++i) {
+                flags.Add(bit);
+                EXPECT_TRUE(flags.HasAll(bit));
+                flags.Remove(bit);
+            }
+
+            flags.Add(bit);
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(static_cast<unsigned int>(flags.Load()), (1U << thread_count) - 1);
+}
@@ -0,0 +1,97 @@
+#include "enum_flags/concurrent_flag_store.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+enum class State : unsigned int {
+    Open = EnumFlags<State>::CreateFlag(0),
+    Authenticated = EnumFlags<State>::CreateFlag(1),
+    Closed = EnumFlags<State>::CreateFlag(2)
+};
+
+}  // namespace
+
+TEST(ConcurrentFlagStore, AddAndRemove) {
+    ConcurrentFlagStore<std::string, State> store {4};
+    EXPECT_FALSE(store.Contains("a"));
+    EXPECT_FALSE(store.Get("a").has_value());
+    EXPECT_EQ(store.Remove("a", State::Open), EnumFlags<State> {});
+
+    EXPECT_EQ(store.Add("a", State::Open), EnumFlags<State> {});
+    EXPECT_EQ(store.Add("a", State::Authenticated), State::Open);
+    EXPECT_EQ(store.Get("a"), (EnumFlags<State> {State::Open, State::Authenticated}));
+    EXPECT_EQ(store.Size(), 1);
+
+    EXPECT_TRUE(store.TestAndAdd("a", State::Open));
+    EXPECT_FALSE(store.TestAndAdd("a", {State::Open, State::Closed}));
+
+    store.Remove("a", {State::Open, State::Authenticated});
+    EXPECT_EQ(store.Get("a"), State::Closed);
+}
+
+TEST(ConcurrentFlagStore, GrowAndScan) {
+    ConcurrentFlagStore<int, State> store {2};
+    for (int i {0}; i != 10000; ++i) {
+        store.Add(i, i % 3 == 0 ? EnumFlags<State> {State::Open, State::Authenticated}
+                                : EnumFlags<State> {State::Open});
+    }
+
+    EXPECT_EQ(store.Size(), 10000);
+    for (int i {0}; i != 10000; ++i) {
+        ASSERT_TRUE(store.Contains(i));
+    }
+
+    auto keys {store.KeysWithAll({State::Open, State::Authenticated}, 4)};
+    std::ranges::sort(keys);
+    ASSERT_EQ(keys.size(), 3334);
+    for (std::size_t i {0}; i != keys.size(); ++i) {
+        EXPECT_EQ(keys[i], static_cast<int>(i * 3));
+    }
+
+    EXPECT_EQ(store.KeysWithAny(State::Closed).size(), 0);
+
+    std::atomic_size_t visits {0};
+    store.ForEach([&visits](int, EnumFlags<State>) { ++visits; }, 4);
+    EXPECT_EQ(visits, 10000);
+}
+
+TEST(ConcurrentFlagStore, ConcurrentWriters) {
+    constexpr int thread_count {4};
+    constexpr int key_count {5000};
+
+    ConcurrentFlagStore<int, State> store {8};
+    std::vector<std::thread> threads;
+    for (int t {0}; t != thread_count; ++t) {
+        threads.emplace_back([&store, t] {
+            for (int i {0}; i != key_count; ++i) {
+                // Every thread inserts the same keys, so inserts and resizes race.
+                store.Add(i, t % 2 == 0 ? State::Open : State::Authenticated);
+                EXPECT_TRUE(store.Contains(i));
+            }
+        });
+    }
+
+    std::atomic_bool done {false};
+    std::thread scanner {[&store, &done] {
+        while (!done) {
+            EXPECT_TRUE(store.KeysWithAny(State::Closed, 2).empty());
+        }
+    }};
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    done = true;
+    scanner.join();
+
+    EXPECT_EQ(store.Size(), key_count);
+    EXPECT_EQ(store.KeysWithAll({State::Open, State::Authenticated}).size(), key_count);
+}
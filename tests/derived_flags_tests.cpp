@@ -0,0 +1,72 @@
+#include "enum_flags/derived_flags.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+namespace {
+
+enum class Opt : std::uint8_t {
+    Connected = EnumFlags<Opt>::CreateFlag(0),
+    Degraded = EnumFlags<Opt>::CreateFlag(1),
+    Synced = EnumFlags<Opt>::CreateFlag(2),
+    Maintenance = EnumFlags<Opt>::CreateFlag(3),
+    Healthy = EnumFlags<Opt>::CreateFlag(4),
+    Serving = EnumFlags<Opt>::CreateFlag(5),
+    Alert = EnumFlags<Opt>::CreateFlag(6)
+};
+
+using Health = DerivedFlags<
+    Opt,
+    DerivedFlag<Opt::Healthy, FlagAnd<FlagIs<Opt::Connected>, FlagNot<FlagIs<Opt::Degraded>>,
+                                      FlagIs<Opt::Synced>>>,
+    DerivedFlag<Opt::Serving, FlagAnd<FlagIs<Opt::Healthy>, FlagNot<FlagIs<Opt::Maintenance>>>>,
+    DerivedFlag<Opt::Alert, FlagOr<FlagIs<Opt::Degraded>, FlagNot<FlagIs<Opt::Connected>>>>>;
+
+}  // namespace
+
+TEST(DerivedFlags, Dependencies) {
+    static_assert(Health::derived_mask
+                  == EnumFlags<Opt> {Opt::Healthy, Opt::Serving, Opt::Alert});
+    static_assert(Health::Dependencies(Opt::Healthy)
+                  == EnumFlags<Opt> {Opt::Connected, Opt::Degraded, Opt::Synced});
+    static_assert(Health::Dependencies(Opt::Serving)
+                  == EnumFlags<Opt> {Opt::Connected, Opt::Degraded, Opt::Synced,
+                                     Opt::Maintenance, Opt::Healthy});
+    EXPECT_EQ(Health::Dependencies(Opt::Alert), (EnumFlags<Opt> {Opt::Connected, Opt::Degraded}));
+}
+
+TEST(DerivedFlags, InitialEvaluation) {
+    constexpr Health empty;
+    static_assert(empty.Load() == Opt::Alert);
+
+    const Health flags {{Opt::Connected, Opt::Synced, Opt::Healthy}};
+    EXPECT_EQ(flags.Load(),
+              (EnumFlags<Opt> {Opt::Connected, Opt::Synced, Opt::Healthy, Opt::Serving}));
+}
+
+TEST(DerivedFlags, IncrementalUpdates) {
+    Health flags;
+    flags.Add(Opt::Connected);
+    EXPECT_FALSE(flags.Has(Opt::Alert));
+    EXPECT_FALSE(flags.Has(Opt::Healthy));
+
+    flags.Add(Opt::Synced);
+    EXPECT_TRUE(flags.HasAll({Opt::Healthy, Opt::Serving}));
+
+    flags.Add(Opt::Maintenance);
+    EXPECT_TRUE(flags.Has(Opt::Healthy));
+    EXPECT_FALSE(flags.Has(Opt::Serving));
+
+    flags.Remove(Opt::Maintenance).Add(Opt::Degraded);
+    EXPECT_FALSE(flags.HasAny({Opt::Healthy, Opt::Serving}));
+    EXPECT_TRUE(flags.Has(Opt::Alert));
+
+    // Derived flags cannot be set or cleared directly.
+    flags.Add(Opt::Healthy);
+    EXPECT_FALSE(flags.Has(Opt::Healthy));
+    flags.Set({Opt::Connected, Opt::Synced});
+    flags.Remove(Opt::Serving);
+    EXPECT_TRUE(flags.HasAll({Opt::Healthy, Opt::Serving}));
+    EXPECT_FALSE(flags.Has(Opt::Alert));
+}
@@ -2,6 +2,7 @@
 
 #include <gtest/gtest.h>
 
+#include <cstdint>
 #include <list>
 #include <unordered_set>
 #include <vector>
@@ -16,6 +17,17 @@ enum class Opt : unsigned int {
     E = EnumFlags<Opt>::CreateFlag(4)
 };
 
+enum class Sparse : std::uint8_t {
+    A = EnumFlags<Sparse>::CreateFlag(1),
+    B = EnumFlags<Sparse>::CreateFlag(5)
+};
+
+enum class Bits : std::uint64_t {};
+
+enum class Declared : std::uint16_t {
+    A = EnumFlags<Declared>::CreateFlag(0)
+};
+
 template <typename T>
 class TypedEnumFlags : public testing::Test {};
 
@@ -23,6 +35,11 @@ using FlagContainers = testing::Types<std::unordered_set<Opt>, std::initializer_
                                       std::vector<Opt>, std::list<Opt>>;
 }  // namespace
 
+template <>
+struct EnumFlagsTraits<Declared> {
+    static constexpr std::uint16_t valid_mask {0x0F0F};
+};
+
 TYPED_TEST_SUITE(TypedEnumFlags, FlagContainers);
 
 TYPED_TEST(TypedEnumFlags, Construction) {
@@ -61,6 +78,20 @@ TEST(EnumFlags, Assignment) {
     EXPECT_TRUE(flags & Opt::D);
 }
 
+TEST(EnumFlags, IterateFlags) {
+    const EnumFlags<Opt> flags {Opt::A, Opt::C, Opt::E};
+    EXPECT_EQ(flags.Count(), 3);
+    EXPECT_EQ(EnumFlags<Opt> {}.Count(), 0);
+
+    std::vector<Opt> opts;
+    flags.ForEach([&opts](const Opt opt) { opts.push_back(opt); });
+    EXPECT_EQ(opts, (std::vector<Opt> {Opt::A, Opt::C, Opt::E}));
+
+    std::vector<std::size_t> bits;
+    flags.ForEachBit([&bits](const std::size_t bit) { bits.push_back(bit); });
+    EXPECT_EQ(bits, (std::vector<std::size_t> {0, 2, 4}));
+}
+
 TEST(EnumFlags, AddFlags) {
     EnumFlags<Opt> flags;
 
@@ -133,4 +164,58 @@ TEST(EnumFlags, SwapFlags) {
 TEST(EnumFlags, Comparison) {
     EXPECT_EQ((EnumFlags<Opt> {Opt::A, Opt::B}), (EnumFlags<Opt> {Opt::A, Opt::B}));
     EXPECT_NE((EnumFlags<Opt> {Opt::A, Opt::B}), (EnumFlags<Opt> {Opt::A, Opt::C}));
-}
\ No newline at end of file
+}
+
+TEST(EnumFlags, Traits) {
+    static_assert(FlagTraits<Opt>::valid_mask == 0b11111);
+    static_assert(FlagTraits<Opt>::count == 5);
+    static_assert(FlagTraits<Opt>::max_bit == 4);
+    static_assert(FlagTraits<Opt>::bit_width == 5);
+    static_assert(FlagTraits<Opt>::is_dense);
+
+    static_assert(FlagTraits<Sparse>::valid_mask == 0b100010);
+    static_assert(FlagTraits<Sparse>::count == 2);
+    static_assert(FlagTraits<Sparse>::max_bit == 5);
+    static_assert(!FlagTraits<Sparse>::is_dense);
+
+    // Without enumerators, every bit is valid.
+    static_assert(FlagTraits<Bits>::count == 64);
+    static_assert(FlagTraits<Bits>::is_dense);
+
+    static_assert(FlagTraits<Declared>::valid_mask == 0x0F0F);
+    static_assert(FlagTraits<Declared>::max_bit == 11);
+}
+
+TEST(EnumFlags, ValidFlags) {
+    EXPECT_EQ(EnumFlags<Opt>::All(), (EnumFlags<Opt> {Opt::A, Opt::B, Opt::C, Opt::D, Opt::E}));
+    EXPECT_EQ(EnumFlags<Sparse>::All(), (EnumFlags<Sparse> {Sparse::A, Sparse::B}));
+
+    const EnumFlags<Opt> flags {Opt::A, Opt::C};
+    EXPECT_EQ(flags.Complement(), (EnumFlags<Opt> {Opt::B, Opt::D, Opt::E}));
+    EXPECT_EQ(~flags, flags.Complement());
+    EXPECT_EQ(~EnumFlags<Opt>::All(), EnumFlags<Opt> {});
+
+    EnumFlags<Sparse> wire {0xFF};
+    EXPECT_FALSE(wire.IsValid());
+    EXPECT_EQ(wire.Sanitize(), (EnumFlags<Sparse> {Sparse::A, Sparse::B}));
+    EXPECT_TRUE(wire.IsValid());
+    EXPECT_EQ(EnumFlags<Sparse> {Sparse::A}.Complement(), Sparse::B);
+}
+
+namespace {
+
+template <EnumFlags<Opt> Flags>
+struct Specialized {
+    static constexpr auto count {Flags.Count()};
+};
+
+}  // namespace
+
+TEST(EnumFlags, TemplateParameter) {
+    static_assert(Specialized<EnumFlags<Opt> {Opt::A, Opt::C}>::count == 2);
+    static_assert(Specialized<Opt::B>::count == 1);
+    static_assert(Specialized<{}>::count == 0);
+    static_assert(std::same_as<Specialized<EnumFlags<Opt> {Opt::A, Opt::C}>,
+                               Specialized<EnumFlags<Opt> {Opt::C, Opt::A}>>);
+    static_assert(!std::same_as<Specialized<Opt::A>, Specialized<Opt::B>>);
+}
@@ -0,0 +1,137 @@
+#include "enum_flags/flag_codecs.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace {
+
+enum class Opt : unsigned int {
+    A = EnumFlags<Opt>::CreateFlag(0),
+    B = EnumFlags<Opt>::CreateFlag(1),
+    C = EnumFlags<Opt>::CreateFlag(2),
+    D = EnumFlags<Opt>::CreateFlag(3),
+    E = EnumFlags<Opt>::CreateFlag(31)
+};
+
+using Flags = EnumFlags<Opt>;
+
+constexpr std::size_t count {1000};
+
+//! Long runs of a few values.
+std::vector<Flags> MakeRuns() {
+    std::vector<Flags> flags;
+    for (std::size_t i {0}; i != count; ++i) {
+        flags.emplace_back(static_cast<unsigned int>(i / 100 % 4));
+    }
+
+    return flags;
+}
+
+//! Values changing in a few low bits.
+std::vector<Flags> MakeSlowlyChanging() {
+    std::mt19937 gen {0};
+    std::vector<Flags> flags;
+    for (std::size_t i {0}; i != count; ++i) {
+        flags.emplace_back(static_cast<unsigned int>((i / 10) << 8 | (gen() & 0xF)));
+    }
+
+    return flags;
+}
+
+//! Random values from a small set of wide values.
+std::vector<Flags> MakeLowCardinality() {
+    constexpr std::array<unsigned int, 3> values {0x80000001, 0x40000002, 0x7};
+    std::mt19937 gen {0};
+    std::vector<Flags> flags;
+    for (std::size_t i {0}; i != count; ++i) {
+        flags.emplace_back(values[gen() % values.size()]);
+    }
+
+    return flags;
+}
+
+std::vector<Flags> MakeRandom() {
+    std::mt19937 gen {0};
+    std::vector<Flags> flags;
+    for (std::size_t i {0}; i != count; ++i) {
+        flags.emplace_back(static_cast<unsigned int>(gen()));
+    }
+
+    return flags;
+}
+
+}  // namespace
+
+TEST(FlagCodecs, RoundTrip) {
+    for (const auto& flags : {MakeRuns(), MakeSlowlyChanging(), MakeLowCardinality(), MakeRandom(),
+                              std::vector<Flags> {Opt::E}}) {
+        for (const auto codec : {FlagCodec::Raw, FlagCodec::RunLength, FlagCodec::DeltaXor,
+                                 FlagCodec::Dictionary}) {
+            const auto block {EncodedFlags<Opt>::Encode(flags, codec)};
+            EXPECT_EQ(block.Codec(), codec);
+            EXPECT_EQ(block.Size(), flags.size());
+            EXPECT_EQ(block.Decode(), flags);
+        }
+    }
+}
+
+TEST(FlagCodecs, EmptyBlock) {
+    const auto block {EncodedFlags<Opt>::Encode({})};
+    EXPECT_EQ(block.Size(), 0);
+    EXPECT_EQ(block.EncodedBytes(), 0);
+    EXPECT_TRUE(block.Decode().empty());
+    EXPECT_EQ(block.CountHasAny(Opt::A), 0);
+}
+
+TEST(FlagCodecs, AdaptiveChoice) {
+    const auto runs {EncodedFlags<Opt>::Encode(MakeRuns())};
+    EXPECT_EQ(runs.Codec(), FlagCodec::RunLength);
+    EXPECT_LT(runs.EncodedBytes(), count * sizeof(Flags) / 10);
+
+    const auto changing {EncodedFlags<Opt>::Encode(MakeSlowlyChanging())};
+    EXPECT_EQ(changing.Codec(), FlagCodec::DeltaXor);
+    EXPECT_LT(changing.EncodedBytes(), count * sizeof(Flags));
+
+    const auto low_cardinality {EncodedFlags<Opt>::Encode(MakeLowCardinality())};
+    EXPECT_EQ(low_cardinality.Codec(), FlagCodec::Dictionary);
+
+    EXPECT_EQ(EncodedFlags<Opt>::ChooseCodec(MakeRandom()), FlagCodec::Raw);
+}
+
+TEST(FlagCodecs, CountPredicates) {
+    const Flags mask {Opt::A, Opt::B};
+    for (const auto& flags : {MakeRuns(), MakeSlowlyChanging(), MakeLowCardinality()}) {
+        const auto all {static_cast<std::size_t>(
+            std::ranges::count_if(flags, [mask](const Flags f) { return f.HasAll(mask); }))};
+        const auto any {static_cast<std::size_t>(
+            std::ranges::count_if(flags, [mask](const Flags f) { return f.HasAny(mask); }))};
+        for (const auto codec : {FlagCodec::Raw, FlagCodec::RunLength, FlagCodec::DeltaXor,
+                                 FlagCodec::Dictionary}) {
+            const auto block {EncodedFlags<Opt>::Encode(flags, codec)};
+            EXPECT_EQ(block.CountHasAll(mask), all);
+            EXPECT_EQ(block.CountHasAny(mask), any);
+        }
+    }
+}
+
+TEST(FlagCodecs, EncodeBlocks) {
+    auto flags {MakeRuns()};
+    const auto random {MakeRandom()};
+    flags.insert(flags.end(), random.begin(), random.end());
+
+    const auto blocks {EncodeFlagBlocks<Opt>(flags, count)};
+    ASSERT_EQ(blocks.size(), 2);
+    EXPECT_EQ(blocks[0].Codec(), FlagCodec::RunLength);
+    EXPECT_EQ(blocks[1].Codec(), FlagCodec::Raw);
+
+    std::vector<Flags> decoded;
+    for (const auto& block : blocks) {
+        const auto values {block.Decode()};
+        decoded.insert(decoded.end(), values.begin(), values.end());
+    }
+
+    EXPECT_EQ(decoded, flags);
+}
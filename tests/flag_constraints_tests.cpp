@@ -0,0 +1,80 @@
+#include "enum_flags/flag_constraints.h"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+enum class Opt : unsigned int {
+    ModeA = EnumFlags<Opt>::CreateFlag(0),
+    ModeB = EnumFlags<Opt>::CreateFlag(1),
+    ModeC = EnumFlags<Opt>::CreateFlag(2),
+    Gzip = EnumFlags<Opt>::CreateFlag(3),
+    Zstd = EnumFlags<Opt>::CreateFlag(4),
+    Encrypted = EnumFlags<Opt>::CreateFlag(5),
+    Signed = EnumFlags<Opt>::CreateFlag(6),
+    Plain = EnumFlags<Opt>::CreateFlag(7)
+};
+
+constexpr auto constraints {FlagConstraints<Opt> {}
+                                .ExactlyOne({Opt::ModeA, Opt::ModeB, Opt::ModeC})
+                                .AtMostOne({Opt::Gzip, Opt::Zstd})
+                                .Requires(Opt::Encrypted, Opt::Signed)
+                                .Excludes(Opt::Plain, {Opt::Encrypted, Opt::Gzip, Opt::Zstd})};
+
+}  // namespace
+
+TEST(FlagConstraints, Validate) {
+    static_assert(constraints.Size() == 4);
+    static_assert(constraints.Validate(Opt::ModeA));
+    static_assert(!constraints.Validate({}));
+
+    EXPECT_TRUE(constraints.Validate({Opt::ModeB, Opt::Zstd, Opt::Encrypted, Opt::Signed}));
+    EXPECT_TRUE(constraints.Validate({Opt::ModeC, Opt::Signed, Opt::Plain}));
+    EXPECT_FALSE(constraints.Validate({Opt::ModeA, Opt::ModeB}));
+    EXPECT_FALSE(constraints.Validate({Opt::ModeA, Opt::Gzip, Opt::Zstd}));
+    EXPECT_FALSE(constraints.Validate({Opt::ModeA, Opt::Encrypted}));
+    EXPECT_FALSE(constraints.Validate({Opt::ModeA, Opt::Plain, Opt::Gzip}));
+}
+
+TEST(FlagConstraints, Violations) {
+    EXPECT_EQ(constraints.Violations(Opt::ModeA), 0);
+    EXPECT_EQ(constraints.Violations({}), 0b0001);
+    EXPECT_EQ(constraints.Violations({Opt::ModeA, Opt::Gzip, Opt::Zstd}), 0b0010);
+    EXPECT_EQ(constraints.Violations({Opt::Encrypted, Opt::Plain}), 0b1101);
+
+    constexpr auto at_least_one {FlagConstraints<Opt> {}.AtLeastOne({Opt::Gzip, Opt::Zstd})};
+    EXPECT_EQ(at_least_one.Violations(Opt::ModeA), 0b1);
+    EXPECT_EQ(at_least_one.Violations({Opt::Gzip, Opt::Zstd}), 0);
+}
+
+TEST(FlagConstraints, BatchValidate) {
+    std::vector<EnumFlags<Opt>> rows;
+    for (std::size_t i {0}; i != 10'000; ++i) {
+        rows.push_back(i % 3 == 0 ? EnumFlags<Opt> {Opt::ModeA, Opt::ModeB} : Opt::ModeC);
+    }
+
+    const auto invalid {constraints.ValidateEach(rows, 4)};
+    ASSERT_EQ(invalid.size(), (rows.size() + 63) / 64);
+    for (std::size_t i {0}; i != rows.size(); ++i) {
+        EXPECT_EQ((invalid[i / 64] >> (i % 64) & 1) != 0, i % 3 == 0);
+    }
+
+    EXPECT_TRUE(constraints.ValidateEach({}).empty());
+}
+
+TEST(FlagConstraints, Limit) {
+    FlagConstraints<Opt> limited;
+    for (std::size_t i {0}; i != FlagConstraints<Opt>::max_constraints; ++i) {
+        limited.AtMostOne({Opt::Gzip, Opt::Zstd});
+    }
+
+    EXPECT_EQ(limited.Size(), FlagConstraints<Opt>::max_constraints);
+    EXPECT_THROW(limited.Requires(Opt::Encrypted, Opt::Signed), std::length_error);
+    EXPECT_EQ(limited.Size(), FlagConstraints<Opt>::max_constraints);
+    EXPECT_EQ(limited.Violations({Opt::Gzip, Opt::Zstd}), ~std::uint64_t {0});
+}
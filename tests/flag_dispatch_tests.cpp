@@ -0,0 +1,69 @@
+#include "enum_flags/flag_dispatch.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <utility>
+
+namespace {
+
+enum class Opt : std::uint8_t {
+    Checksum = EnumFlags<Opt>::CreateFlag(0),
+    Compress = EnumFlags<Opt>::CreateFlag(1),
+    Encrypt = EnumFlags<Opt>::CreateFlag(2),
+    Trace = EnumFlags<Opt>::CreateFlag(7)
+};
+
+using Flags = EnumFlags<Opt>;
+
+template <bool Checksum, bool Compress>
+int Kernel(const int value) noexcept {
+    return value + (Checksum ? 10 : 0) + (Compress ? 100 : 0);
+}
+
+}  // namespace
+
+TEST(FlagDispatch, Bits) {
+    static_assert(CompressBits<std::uint8_t>(0b1000'0101, 0b1000'0101) == 0b111);
+    static_assert(CompressBits<std::uint8_t>(0b1000'0001, 0b1000'0100) == 0b10);
+    static_assert(CompressBits<std::uint8_t>(0b1111'0110, 0b0000'0111) == 0b110);
+    static_assert(DepositBits<std::uint8_t>(0b10, 0b1000'0100) == 0b1000'0000);
+    static_assert(DepositBits<std::uint8_t>(0b11, 0b0000'0011) == 0b11);
+}
+
+TEST(FlagDispatch, Dispatch) {
+    for (unsigned int raw {0}; raw != 0x100; ++raw) {
+        const Flags flags {static_cast<std::uint8_t>(raw)};
+        const auto result {Dispatch(flags, []<typename Static>(const Static) noexcept {
+            static_assert(Static::value == Flags {Static::value}.Sanitize());
+            return static_cast<unsigned int>(Static::value);
+        })};
+        EXPECT_EQ(result, static_cast<unsigned int>(Flags {flags}.Sanitize()));
+    }
+}
+
+TEST(FlagDispatch, ConstantInInstantiation) {
+    constexpr auto mask {static_cast<std::uint8_t>(std::to_underlying(Opt::Checksum)
+                                                   | std::to_underlying(Opt::Compress))};
+    const auto run {[](const Flags flags, const int value) {
+        return Dispatch<Opt, mask>(flags, [value](const auto static_flags) noexcept {
+            using Static = decltype(static_flags);
+            if constexpr (Static::Has(Opt::Encrypt)) {
+                return -1;
+            } else {
+                return Kernel<Static::Has(Opt::Checksum), Static::Has(Opt::Compress)>(value);
+            }
+        });
+    }};
+
+    EXPECT_EQ(run({}, 1), 1);
+    EXPECT_EQ(run(Opt::Checksum, 1), 11);
+    EXPECT_EQ(run({Opt::Compress, Opt::Trace}, 1), 101);
+    // Flags outside the mask are ignored.
+    EXPECT_EQ(run({Opt::Checksum, Opt::Compress, Opt::Encrypt}, 1), 111);
+
+    const Flags flags {Dispatch<Opt, mask>(Opt::Compress, [](const auto static_flags) noexcept {
+        return Flags {static_flags};
+    })};
+    EXPECT_EQ(flags, Opt::Compress);
+}
@@ -0,0 +1,115 @@
+#include "enum_flags/flag_expressions.h"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace {
+
+enum class Opt : unsigned int {
+    A = EnumFlags<Opt>::CreateFlag(0),
+    B = EnumFlags<Opt>::CreateFlag(1),
+    C = EnumFlags<Opt>::CreateFlag(2),
+    D = EnumFlags<Opt>::CreateFlag(3)
+};
+
+using Flags = EnumFlags<Opt>;
+
+template <typename Expr>
+concept Countable = requires(const Expr& expr) { CountAny(expr); };
+
+template <typename Expr>
+concept ScalarEvaluable = requires(const Expr& expr) {
+    Evaluate(expr);
+    expr.HasAny();
+};
+
+template <typename Rows>
+concept Wrappable = requires(Rows&& rows) { Lazy(std::forward<Rows>(rows)); };
+
+}  // namespace
+
+TEST(FlagExpressions, Scalar) {
+    constexpr Flags a {Opt::A, Opt::B};
+    constexpr Flags b {Opt::B, Opt::C};
+    static_assert(Evaluate(Lazy(a) & b) == Opt::B);
+    static_assert(Evaluate(Lazy(a) - b) == Opt::A);
+    static_assert(Evaluate(Lazy(a) ^ b) == Flags {Opt::A, Opt::C});
+
+    const Flags flags {((Lazy(a) | b) - Opt::B) | Opt::D};
+    EXPECT_EQ(flags, (Flags {Opt::A, Opt::C, Opt::D}));
+
+    EXPECT_TRUE((Lazy(a) & b).Has(Opt::B));
+    EXPECT_FALSE((Lazy(a) & b).HasAny({Opt::A, Opt::C}));
+    EXPECT_TRUE((a ^ Lazy(b)).HasAll({Opt::A, Opt::C}));
+    EXPECT_FALSE((Lazy(a) - a).HasAny());
+
+    // The intersection of plain flags still checks for all flags.
+    EXPECT_FALSE(a & b);
+}
+
+TEST(FlagExpressions, Columns) {
+    std::vector<Flags> lhs, rhs;
+    for (unsigned int i {0}; i != 10'000; ++i) {
+        lhs.emplace_back(i % 16);
+        rhs.emplace_back(i / 16 % 16);
+    }
+
+    const auto expr {((Lazy(lhs) | Lazy(rhs)) - Opt::A) ^ Flags {Opt::D}};
+    std::vector<Flags> output(lhs.size());
+    Evaluate(expr, std::span {output}, 4);
+    for (std::size_t i {0}; i != output.size(); ++i) {
+        const auto raw {static_cast<unsigned int>(lhs[i]) | static_cast<unsigned int>(rhs[i])};
+        EXPECT_EQ(output[i], Flags {(raw & ~0b0001U) ^ 0b1000U});
+    }
+
+    std::size_t any {0};
+    for (std::size_t i {0}; i != lhs.size(); ++i) {
+        any += lhs[i].HasAny(rhs[i]) ? 1 : 0;
+    }
+
+    EXPECT_EQ(CountAny(Lazy(lhs) & Lazy(rhs), 4), any);
+}
+
+TEST(FlagExpressions, OutputAliasesInput) {
+    std::vector<Flags> rows {Opt::A, Opt::B, {Opt::A, Opt::C}};
+    Evaluate(Lazy(rows) ^ Opt::A, std::span {rows});
+    EXPECT_EQ(rows, (std::vector<Flags> {{}, {Opt::A, Opt::B}, Opt::C}));
+}
+
+TEST(FlagExpressions, ScalarBroadcast) {
+    constexpr auto expr {Lazy(Flags {Opt::A, Opt::B}) - Opt::B};
+    static_assert(!decltype(expr)::has_columns);
+    static_assert(!Countable<decltype(expr)>);
+
+    std::vector<Flags> output(3);
+    Evaluate(expr, std::span {output});
+    EXPECT_EQ(output, (std::vector<Flags> {Opt::A, Opt::A, Opt::A}));
+
+    // The number of evaluated rows is bounded by the output.
+    std::vector<Flags> rows {Opt::A, Opt::B, Opt::C};
+    std::vector<Flags> shorter(2);
+    Evaluate(Lazy(rows) | Opt::D, std::span {shorter});
+    EXPECT_EQ(shorter, (std::vector<Flags> {{Opt::A, Opt::D}, {Opt::B, Opt::D}}));
+}
+
+TEST(FlagExpressions, RejectTemporaryColumns) {
+    static_assert(!Wrappable<std::vector<Flags>>);
+    static_assert(Wrappable<std::vector<Flags>&>);
+    static_assert(Wrappable<std::span<const Flags>>);
+}
+
+TEST(FlagExpressions, ColumnsNeedOutput) {
+    using Scalar = decltype(Lazy(Flags {Opt::A}) | Opt::B);
+    static_assert(std::is_convertible_v<Scalar, Flags>);
+    static_assert(ScalarEvaluable<Scalar>);
+
+    // Expressions over columns can only be evaluated into an output buffer.
+    using Column = decltype(Lazy(std::declval<std::vector<Flags>&>()) | Opt::B);
+    static_assert(!std::is_convertible_v<Column, Flags>);
+    static_assert(!ScalarEvaluable<Column>);
+}
@@ -0,0 +1,66 @@
+#include "enum_flags/flag_layers.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+enum class Opt : unsigned int {
+    Gzip = EnumFlags<Opt>::CreateFlag(0),
+    Log = EnumFlags<Opt>::CreateFlag(1),
+    Trace = EnumFlags<Opt>::CreateFlag(2),
+    Cache = EnumFlags<Opt>::CreateFlag(3)
+};
+
+using Override = FlagOverride<Opt>;
+
+}  // namespace
+
+TEST(FlagLayers, Override) {
+    constexpr auto tenant {Override {}.Set(Opt::Trace).Clear({Opt::Log, Opt::Cache})};
+    static_assert(tenant.Sets() == Opt::Trace);
+    static_assert(tenant.Clears() == EnumFlags<Opt> {Opt::Log, Opt::Cache});
+    static_assert(tenant.Specified() == EnumFlags<Opt> {Opt::Trace, Opt::Log, Opt::Cache});
+    static_assert(tenant.Apply({Opt::Gzip, Opt::Log}) == EnumFlags<Opt> {Opt::Gzip, Opt::Trace});
+
+    // A later specification of a flag replaces an earlier one.
+    static_assert(Override {}.Set(Opt::Log).Clear(Opt::Log).Apply(Opt::Log) == EnumFlags<Opt> {});
+    static_assert(Override {}.Set(Opt::Log).Unset(Opt::Log) == Override {});
+
+    constexpr auto user {Override {}.Set(Opt::Cache).Clear(Opt::Trace)};
+    for (unsigned int base {0}; base != 16; ++base) {
+        EXPECT_EQ(tenant.Then(user).Apply(base), user.Apply(tenant.Apply(base)));
+    }
+}
+
+TEST(FlagLayers, Resolve) {
+    FlagLayer<Opt> tenant, user;
+    FlagLayerChain<Opt> chain {{Opt::Gzip, Opt::Log}, {&tenant, &user}};
+    EXPECT_EQ(chain.Recomputations(), 2);
+    EXPECT_EQ(chain.Resolve(), (EnumFlags<Opt> {Opt::Gzip, Opt::Log}));
+
+    tenant.Clear(Opt::Log);
+    user.Set(Opt::Trace);
+    EXPECT_EQ(chain.Resolve(), (EnumFlags<Opt> {Opt::Gzip, Opt::Trace}));
+    EXPECT_EQ(chain.Recomputations(), 4);
+
+    // A cached result is reused until a layer changes.
+    EXPECT_EQ(chain.Resolve(Override {}.Clear(Opt::Gzip).Set(Opt::Cache)),
+              (EnumFlags<Opt> {Opt::Trace, Opt::Cache}));
+    EXPECT_EQ(chain.Resolve(), (EnumFlags<Opt> {Opt::Gzip, Opt::Trace}));
+    EXPECT_EQ(chain.Recomputations(), 4);
+
+    // Only the changed layer and those above it are recomputed.
+    user.Set(Opt::Log);
+    EXPECT_EQ(chain.Resolve(), (EnumFlags<Opt> {Opt::Gzip, Opt::Log, Opt::Trace}));
+    EXPECT_EQ(chain.Recomputations(), 5);
+
+    // Storing the same override does not invalidate the cache.
+    const auto version {tenant.Version()};
+    tenant.Clear(Opt::Log);
+    EXPECT_EQ(tenant.Version(), version);
+    EXPECT_EQ(chain.Resolve(), (EnumFlags<Opt> {Opt::Gzip, Opt::Log, Opt::Trace}));
+    EXPECT_EQ(chain.Recomputations(), 5);
+
+    FlagLayerChain<Opt> empty {Opt::Gzip, {}};
+    EXPECT_EQ(empty.Resolve(), Opt::Gzip);
+}
@@ -0,0 +1,92 @@
+#include "enum_flags/flag_partition.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace {
+
+enum class Opt : unsigned int {
+    Active = EnumFlags<Opt>::CreateFlag(0),
+    Deleted = EnumFlags<Opt>::CreateFlag(1),
+    Pinned = EnumFlags<Opt>::CreateFlag(2)
+};
+
+struct Record {
+    std::size_t id;
+    EnumFlags<Opt> flags;
+
+    bool operator==(const Record&) const noexcept = default;
+};
+
+constexpr FlagQuery<Opt> query {Opt::Active, Opt::Deleted};
+
+std::vector<Record> MakeRecords(const std::size_t count) {
+    std::vector<Record> records;
+    for (std::size_t i {0}; i != count; ++i) {
+        records.push_back({i, static_cast<unsigned int>(i * 5 % 7 % 4)});
+    }
+
+    return records;
+}
+
+}  // namespace
+
+TEST(FlagPartition, CompactIndices) {
+    const auto records {MakeRecords(20'011)};
+    std::vector<std::size_t> expected;
+    for (const auto& record : records) {
+        if (query.Matches(record.flags)) {
+            expected.push_back(record.id);
+        }
+    }
+
+    const std::span<const Record> rows {records};
+    std::vector<std::size_t> indices(records.size());
+    const auto count {CompactIndices(rows, &Record::flags, query, std::span {indices})};
+    indices.resize(count);
+    EXPECT_EQ(indices, expected);
+
+    EXPECT_EQ(CompactIndices(rows, &Record::flags, query, 4), expected);
+    EXPECT_TRUE(CompactIndices(std::span<const Record> {}, &Record::flags, query, 4).empty());
+}
+
+TEST(FlagPartition, PartitionBy) {
+    auto records {MakeRecords(1'000)};
+    const auto count {PartitionBy(std::span {records}, &Record::flags, query)};
+    const auto matched {static_cast<std::ptrdiff_t>(count)};
+    EXPECT_TRUE(std::ranges::is_partitioned(
+        records, [](const Record& record) noexcept { return query.Matches(record.flags); }));
+    EXPECT_EQ(std::ranges::count_if(records.begin(), records.begin() + matched,
+                                    [](const Record& record) noexcept {
+                                        return record.flags.Has(Opt::Active);
+                                    }),
+              matched);
+
+    std::ranges::sort(records, {}, &Record::id);
+    EXPECT_EQ(records, MakeRecords(1'000));
+}
+
+TEST(FlagPartition, StablePartitionBy) {
+    auto records {MakeRecords(20'011)};
+    auto expected {records};
+    const auto expected_end {std::ranges::stable_partition(
+        expected, [](const Record& record) noexcept { return query.Matches(record.flags); })};
+
+    const auto count {StablePartitionBy(std::span {records}, &Record::flags, query, 4)};
+    EXPECT_EQ(count, static_cast<std::size_t>(expected_end.begin() - expected.begin()));
+    EXPECT_EQ(records, expected);
+
+    const auto pinned {StablePartitionBy(std::span {records}, &Record::flags,
+                                         [](const EnumFlags<Opt> flags) noexcept {
+                                             return flags.Has(Opt::Pinned);
+                                         })};
+    EXPECT_TRUE(std::ranges::all_of(records.begin(),
+                                    records.begin() + static_cast<std::ptrdiff_t>(pinned),
+                                    [](const Record& record) noexcept {
+                                        return record.flags.Has(Opt::Pinned);
+                                    }));
+}
@@ -0,0 +1,65 @@
+#include "enum_flags/flag_queries.h"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+enum class Opt : unsigned char {
+    A = EnumFlags<Opt>::CreateFlag(0),
+    B = EnumFlags<Opt>::CreateFlag(1),
+    C = EnumFlags<Opt>::CreateFlag(2),
+    D = EnumFlags<Opt>::CreateFlag(3)
+};
+
+using Flags = EnumFlags<Opt>;
+
+}  // namespace
+
+TEST(FlagQueries, Matches) {
+    constexpr FlagQuery<Opt> query {{Opt::A, Opt::B}, Opt::C};
+    static_assert(query.Matches({Opt::A, Opt::B, Opt::D}));
+    static_assert(!query.Matches({Opt::A, Opt::B, Opt::C}));
+    static_assert(!query.Matches(Opt::A));
+    static_assert(FlagQuery<Opt> {}.Matches({}));
+}
+
+TEST(FlagQueries, Select) {
+    const std::vector<FlagQuery<Opt>> queries {
+        {Opt::A, {}}, {{Opt::A, Opt::B}, Opt::C}, {{}, {Opt::A, Opt::D}}, {Opt::D, Opt::D}};
+    const FlagQueryBatch<Opt> batch {queries};
+    EXPECT_EQ(batch.Size(), queries.size());
+
+    std::vector<Flags> rows;
+    for (std::size_t i {0}; i != 10'007; ++i) {
+        rows.emplace_back(static_cast<unsigned char>(i * 7 % 16));
+    }
+
+    const auto words {FlagQueryBatch<Opt>::WordCount(rows.size())};
+    const auto selection {batch.Select(rows, 4)};
+    ASSERT_EQ(selection.size(), queries.size() * words);
+    for (std::size_t q {0}; q != queries.size(); ++q) {
+        for (std::size_t i {0}; i != rows.size(); ++i) {
+            const auto bit {selection[q * words + i / 64] >> i % 64 & 1};
+            EXPECT_EQ(bit != 0, queries[q].Matches(rows[i]));
+        }
+
+        // Bits beyond the last row are cleared.
+        EXPECT_EQ(selection[q * words + words - 1] >> rows.size() % 64, 0);
+    }
+}
+
+TEST(FlagQueries, Count) {
+    const FlagQueryBatch<Opt> batch {{Opt::A, {}}, {{Opt::A, Opt::B}, Opt::C}, {Opt::D, Opt::D}};
+    std::vector<Flags> rows;
+    for (std::size_t i {0}; i != 10'000; ++i) {
+        rows.emplace_back(static_cast<unsigned char>(i % 16));
+    }
+
+    EXPECT_EQ(batch.Count(rows, 4), (std::vector<std::size_t> {5'000, 1'250, 0}));
+    EXPECT_EQ(batch.Count({}), (std::vector<std::size_t> {0, 0, 0}));
+    EXPECT_TRUE(FlagQueryBatch<Opt> {}.Count(rows).empty());
+}
@@ -0,0 +1,84 @@
+#include "enum_flags/flag_stream.h"
+
+#include <gtest/gtest.h>
+
+#include <set>
+#include <sstream>
+#include <vector>
+
+namespace {
+
+enum class Opt : unsigned int {
+    A = EnumFlags<Opt>::CreateFlag(0),
+    B = EnumFlags<Opt>::CreateFlag(1),
+    C = EnumFlags<Opt>::CreateFlag(2)
+};
+
+std::vector<EnumFlags<Opt>> MakeRecords(const std::size_t count) {
+    std::vector<EnumFlags<Opt>> records;
+    for (std::size_t i {0}; i != count; ++i) {
+        records.emplace_back(static_cast<unsigned int>(i % 8));
+    }
+
+    return records;
+}
+
+}  // namespace
+
+TEST(FlagStream, RoundTrip) {
+    const auto records {MakeRecords(10)};
+    std::stringstream stream;
+    {
+        FlagStreamWriter<Opt> writer {stream, 4};
+        writer.Write(records.front());
+        writer.Write(std::span {records}.subspan(1));
+    }
+
+    FlagStreamReader<Opt> reader {stream, 3};
+    std::vector<EnumFlags<Opt>> read;
+    std::set<const EnumFlags<Opt>*> buffers;
+    for (auto chunk {reader.Next()}; !chunk.empty(); chunk = reader.Next()) {
+        EXPECT_LE(chunk.size(), 3);
+        buffers.insert(chunk.data());
+        read.insert(read.end(), chunk.begin(), chunk.end());
+    }
+
+    EXPECT_EQ(read, records);
+    EXPECT_LE(buffers.size(), 2);
+    EXPECT_FALSE(reader.Truncated());
+    EXPECT_TRUE(reader.Next().empty());
+}
+
+TEST(FlagStream, Flush) {
+    std::stringstream stream;
+    FlagStreamWriter<Opt> writer {stream, 16};
+    writer.Write({Opt::A, Opt::C});
+    EXPECT_TRUE(stream.str().empty());
+
+    writer.Flush();
+    EXPECT_EQ(stream.str().size(), sizeof(EnumFlags<Opt>));
+}
+
+TEST(FlagStream, TruncatedRecord) {
+    const auto records {MakeRecords(5)};
+    std::stringstream stream;
+    stream.write(reinterpret_cast<const char*>(records.data()),
+                 static_cast<std::streamsize>(records.size() * sizeof(EnumFlags<Opt>)));
+    stream.put('\0');
+
+    FlagStreamReader<Opt> reader {stream, 2};
+    std::size_t count {0};
+    for (auto chunk {reader.Next()}; !chunk.empty(); chunk = reader.Next()) {
+        count += chunk.size();
+    }
+
+    EXPECT_EQ(count, records.size());
+    EXPECT_TRUE(reader.Truncated());
+}
+
+TEST(FlagStream, EmptyStream) {
+    std::stringstream stream;
+    FlagStreamReader<Opt> reader {stream, 4};
+    EXPECT_TRUE(reader.Next().empty());
+    EXPECT_FALSE(reader.Truncated());
+}
@@ -0,0 +1,56 @@
+#include "enum_flags/flag_templates.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+enum class Stage : std::uint8_t {
+    Decode = EnumFlags<Stage>::CreateFlag(0),
+    Verify = EnumFlags<Stage>::CreateFlag(1),
+    Compress = EnumFlags<Stage>::CreateFlag(2),
+    Encrypt = EnumFlags<Stage>::CreateFlag(5)
+};
+
+template <EnumFlags<Stage> Stages>
+std::vector<Stage> RunPipeline() {
+    std::vector<Stage> stages;
+    ToFlagList_t<Stages>::ForEach([&stages](const auto stage) {
+        static_assert(HasFlag_v<Stages, stage()>);
+        stages.push_back(stage);
+    });
+
+    return stages;
+}
+
+}  // namespace
+
+TEST(FlagTemplates, HasFlag) {
+    constexpr EnumFlags<Stage> stages {Stage::Decode, Stage::Encrypt};
+    static_assert(HasFlag_v<stages, Stage::Decode>);
+    static_assert(!HasFlag_v<stages, Stage::Verify>);
+    static_assert(HasFlag_v<EnumFlags<Stage> {Stage::Verify}, Stage::Verify>);
+}
+
+TEST(FlagTemplates, FlagList) {
+    using List = FlagList<Stage, Stage::Encrypt, Stage::Decode>;
+    static_assert(List::size == 2);
+    static_assert(FlagListFlags_v<List> == EnumFlags<Stage> {Stage::Decode, Stage::Encrypt});
+    static_assert(FlagList<Stage>::flags == EnumFlags<Stage> {});
+
+    static_assert(std::same_as<ToFlagList_t<EnumFlags<Stage> {Stage::Encrypt, Stage::Decode}>,
+                               FlagList<Stage, Stage::Decode, Stage::Encrypt>>);
+    static_assert(std::same_as<ToFlagList_t<EnumFlags<Stage> {}>, FlagList<Stage>>);
+    constexpr auto all {EnumFlags<Stage>::All()};
+    static_assert(FlagListFlags_v<ToFlagList_t<all>> == all);
+}
+
+TEST(FlagTemplates, Specialization) {
+    constexpr EnumFlags<Stage> stages {Stage::Compress, Stage::Decode};
+    EXPECT_EQ(RunPipeline<stages>(), (std::vector<Stage> {Stage::Decode, Stage::Compress}));
+    EXPECT_EQ(RunPipeline<Stage::Verify>(), (std::vector<Stage> {Stage::Verify}));
+    EXPECT_TRUE(RunPipeline<EnumFlags<Stage> {}>().empty());
+}
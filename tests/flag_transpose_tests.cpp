@@ -0,0 +1,102 @@
+#include "enum_flags/flag_transpose.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace {
+
+enum class Narrow : std::uint8_t {
+    A = EnumFlags<Narrow>::CreateFlag(0),
+    B = EnumFlags<Narrow>::CreateFlag(3),
+    C = EnumFlags<Narrow>::CreateFlag(5)
+};
+
+enum class Wide : std::uint64_t {
+    A = EnumFlags<Wide>::CreateFlag(0),
+    B = EnumFlags<Wide>::CreateFlag(17),
+    C = EnumFlags<Wide>::CreateFlag(40)
+};
+
+enum class Full : std::uint32_t {};
+
+template <typename Enum>
+void ExpectRoundTrip(const std::size_t row_count) {
+    using RawType = EnumFlags<Enum>::RawType;
+    constexpr auto valid {static_cast<RawType>(EnumFlags<Enum>::All())};
+    constexpr std::size_t bit_count {FlagTraits<Enum>::bit_width};
+
+    std::mt19937_64 random {row_count};
+    std::vector<EnumFlags<Enum>> rows;
+    for (std::size_t i {0}; i != row_count; ++i) {
+        rows.emplace_back(static_cast<RawType>(random() & valid));
+    }
+
+    const auto bitmaps {TransposeToBitmaps<Enum>(rows, 4)};
+    const auto words {BitmapWordCount(row_count)};
+    ASSERT_EQ(bitmaps.size(), bit_count * words);
+    for (std::size_t bit {0}; bit != bit_count; ++bit) {
+        for (std::size_t i {0}; i != words * 64; ++i) {
+            const auto expected {i < row_count && (static_cast<RawType>(rows[i]) >> bit & 1) != 0};
+            ASSERT_EQ((bitmaps[bit * words + i / 64] >> i % 64 & 1) != 0, expected);
+        }
+    }
+
+    std::vector<EnumFlags<Enum>> restored(row_count);
+    TransposeToRows<Enum>(bitmaps, restored, 4);
+    EXPECT_EQ(restored, rows);
+}
+
+}  // namespace
+
+TEST(FlagTranspose, Kernels) {
+    std::mt19937_64 random {0};
+    for (std::size_t round {0}; round != 16; ++round) {
+        const auto matrix {random()};
+        const auto transposed {TransposeBits8(matrix)};
+        for (std::size_t row {0}; row != 8; ++row) {
+            for (std::size_t col {0}; col != 8; ++col) {
+                EXPECT_EQ(transposed >> (col * 8 + row) & 1, matrix >> (row * 8 + col) & 1);
+            }
+        }
+
+        EXPECT_EQ(TransposeBits8(transposed), matrix);
+    }
+
+    std::array<std::uint64_t, 64> matrix;
+    for (auto& row : matrix) {
+        row = random();
+    }
+
+    auto transposed {matrix};
+    TransposeBits64(transposed);
+    for (std::size_t row {0}; row != 64; ++row) {
+        for (std::size_t col {0}; col != 64; ++col) {
+            EXPECT_EQ(transposed[col] >> row & 1, matrix[row] >> col & 1);
+        }
+    }
+}
+
+TEST(FlagTranspose, RoundTrip) {
+    for (const std::size_t count : {0, 1, 63, 64, 65, 10'000}) {
+        ExpectRoundTrip<Narrow>(count);
+        ExpectRoundTrip<Wide>(count);
+        ExpectRoundTrip<Full>(count);
+    }
+}
+
+TEST(FlagTranspose, DropInvalidBits) {
+    const std::vector<EnumFlags<Narrow>> rows {0xFF, 0x01};
+    const auto bitmaps {TransposeToBitmaps<Narrow>(rows)};
+    ASSERT_EQ(bitmaps.size(), 6);
+    EXPECT_EQ(bitmaps[0], 0b11);
+    EXPECT_EQ(bitmaps[5], 0b01);
+
+    std::vector<EnumFlags<Narrow>> restored(rows.size());
+    TransposeToRows<Narrow>(bitmaps, restored);
+    EXPECT_EQ(restored[0], EnumFlags<Narrow> {0x3F});
+}
@@ -0,0 +1,95 @@
+#include "enum_flags/hamming_search.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <ranges>
+#include <vector>
+
+namespace {
+
+enum class Opt : unsigned int {
+    A = EnumFlags<Opt>::CreateFlag(0),
+    B = EnumFlags<Opt>::CreateFlag(1),
+    C = EnumFlags<Opt>::CreateFlag(2)
+};
+
+}  // namespace
+
+// Rows are random sets over all bits.
+template <>
+struct EnumFlagsTraits<Opt> {
+    static constexpr unsigned int valid_mask {~0U};
+};
+
+namespace {
+
+using Flags = EnumFlags<Opt>;
+
+//! Random rows, some of which are a few bits away from @p query.
+std::vector<Flags> MakeRows(const Flags query) {
+    std::mt19937 gen {0};
+    std::vector<Flags> rows;
+    for (std::size_t i {0}; i != 2000; ++i) {
+        auto value {static_cast<unsigned int>(gen())};
+        if (i % 10 == 0) {
+            value = static_cast<unsigned int>(query);
+            for (std::size_t j {0}; j != i % 7; ++j) {
+                value ^= 1U << (gen() % 32);
+            }
+        }
+
+        rows.emplace_back(value);
+    }
+
+    return rows;
+}
+
+std::vector<HammingNeighbor> BruteForce(const std::vector<Flags>& rows, const Flags query) {
+    std::vector<HammingNeighbor> neighbors;
+    for (std::size_t i {0}; i != rows.size(); ++i) {
+        neighbors.push_back({i, HammingDistance(rows[i], query)});
+    }
+
+    std::ranges::sort(neighbors);
+    return neighbors;
+}
+
+}  // namespace
+
+TEST(HammingSearch, Distance) {
+    EXPECT_EQ(HammingDistance<Opt>({Opt::A, Opt::B}, {Opt::B, Opt::C}), 2);
+    EXPECT_EQ(HammingDistance<Opt>(Opt::A, Opt::A), 0);
+}
+
+TEST(HammingSearch, NearestNeighbors) {
+    const Flags query {0x12345678U};
+    const auto rows {MakeRows(query)};
+    const auto expected {BruteForce(rows, query)};
+    for (const std::size_t k : {0, 1, 5, 100, 5000}) {
+        const auto neighbors {NearestNeighbors<Opt>(rows, query, k)};
+        ASSERT_EQ(neighbors.size(), std::min(k, rows.size()));
+        EXPECT_TRUE(std::ranges::equal(neighbors, expected | std::views::take(k)));
+    }
+}
+
+TEST(HammingSearch, MultiIndexRadiusSearch) {
+    const Flags query {0x12345678U};
+    const auto rows {MakeRows(query)};
+    const auto all {BruteForce(rows, query)};
+
+    MultiIndexHashTable<Opt> table {4};
+    for (const auto row : rows) {
+        table.Insert(row);
+    }
+
+    ASSERT_EQ(table.Size(), rows.size());
+    EXPECT_EQ(table[3], rows[3]);
+    for (const std::size_t radius : {0, 1, 3, 4, 7, 10}) {
+        std::vector<HammingNeighbor> expected;
+        std::ranges::copy_if(all, std::back_inserter(expected),
+                             [radius](const auto& n) { return n.distance <= radius; });
+        EXPECT_EQ(table.RadiusSearch(query, radius), expected);
+    }
+}
@@ -0,0 +1,78 @@
+#include "enum_flags/implication_graph.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+namespace {
+
+enum class Perm : std::uint16_t {
+    Read = EnumFlags<Perm>::CreateFlag(0),
+    Write = EnumFlags<Perm>::CreateFlag(1),
+    Delete = EnumFlags<Perm>::CreateFlag(2),
+    Admin = EnumFlags<Perm>::CreateFlag(3),
+    List = EnumFlags<Perm>::CreateFlag(9),
+    Audit = EnumFlags<Perm>::CreateFlag(12),
+    Review = EnumFlags<Perm>::CreateFlag(15)
+};
+
+constexpr ImplicationGraph<Perm> graph {
+    {Perm::Admin, {Perm::Write, Perm::Delete}},
+    {Perm::Write, Perm::Read},
+    {Perm::Read, Perm::List},
+    {{Perm::Delete, Perm::Review}, Perm::Audit},
+    // A cycle.
+    {Perm::Audit, Perm::Review}};
+
+//! An enumeration whose width is not a multiple of a byte.
+enum class Step : std::uint8_t {
+    Fetch = EnumFlags<Step>::CreateFlag(0),
+    Parse = EnumFlags<Step>::CreateFlag(1),
+    Check = EnumFlags<Step>::CreateFlag(2),
+    Build = EnumFlags<Step>::CreateFlag(3),
+    Ship = EnumFlags<Step>::CreateFlag(4)
+};
+
+}  // namespace
+
+TEST(ImplicationGraph, Implied) {
+    static_assert(graph.Implies(Perm::Admin, Perm::List));
+    static_assert(!graph.Implies(Perm::Read, Perm::Write));
+    EXPECT_EQ(graph.Implied(Perm::Write), (EnumFlags<Perm> {Perm::Write, Perm::Read, Perm::List}));
+    EXPECT_EQ(graph.Implied(Perm::Audit), (EnumFlags<Perm> {Perm::Audit, Perm::Review}));
+    EXPECT_EQ(graph.Implied(Perm::Review), (EnumFlags<Perm> {Perm::Audit, Perm::Review}));
+}
+
+TEST(ImplicationGraph, Close) {
+    static_assert(graph.Close(Perm::Admin)
+                  == EnumFlags<Perm> {Perm::Admin, Perm::Write, Perm::Delete, Perm::Read,
+                                      Perm::List, Perm::Audit, Perm::Review});
+    EXPECT_EQ(graph.Close({}), EnumFlags<Perm> {});
+    EXPECT_EQ(graph.Close(Perm::List), Perm::List);
+    EXPECT_EQ(graph.Close({Perm::Read, Perm::Review}),
+              (EnumFlags<Perm> {Perm::Read, Perm::List, Perm::Audit, Perm::Review}));
+
+    // Bits that are not valid flags are removed.
+    EXPECT_EQ(graph.Close(EnumFlags<Perm> {0x10}.Add(Perm::List)), Perm::List);
+
+    EXPECT_TRUE(graph.IsClosed({Perm::Read, Perm::List}));
+    EXPECT_FALSE(graph.IsClosed(Perm::Write));
+}
+
+TEST(ImplicationGraph, RuntimeGraph) {
+    const ImplicationGraph<Perm> runtime {{Perm::Write, Perm::Read}};
+    EXPECT_EQ(runtime.Close({Perm::Write, Perm::Admin}),
+              (EnumFlags<Perm> {Perm::Admin, Perm::Write, Perm::Read}));
+}
+
+TEST(ImplicationGraph, PartialByte) {
+    constexpr ImplicationGraph<Step> steps {
+        {Step::Ship, Step::Build}, {Step::Build, Step::Check}, {Step::Check, Step::Parse}};
+    static_assert(steps.Implies(Step::Ship, Step::Parse));
+    static_assert(steps.Close(Step::Ship)
+                  == EnumFlags<Step> {Step::Ship, Step::Build, Step::Check, Step::Parse});
+    EXPECT_EQ(steps.Close(EnumFlags<Step> {0xE0}.Add(Step::Fetch)), Step::Fetch);
+
+    const ImplicationGraph<Step> runtime {{Step::Parse, Step::Fetch}};
+    EXPECT_EQ(runtime.Close(Step::Parse), (EnumFlags<Step> {Step::Parse, Step::Fetch}));
+}
@@ -0,0 +1,80 @@
+#include "enum_flags/min_hash.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace {
+
+enum class Feature : std::uint64_t {};
+
+using Flags = EnumFlags<Feature>;
+
+std::vector<Flags> MakeSets() {
+    std::mt19937_64 gen {0};
+    std::vector<Flags> sets;
+    for (std::size_t i {0}; i != 500; ++i) {
+        sets.emplace_back(gen() & gen());
+    }
+
+    return sets;
+}
+
+}  // namespace
+
+TEST(MinHash, JaccardSimilarity) {
+    EXPECT_DOUBLE_EQ(JaccardSimilarity(Flags {0b0111U}, Flags {0b1110U}), 0.5);
+    EXPECT_DOUBLE_EQ(JaccardSimilarity(Flags {0b1U}, Flags {0b10U}), 0.0);
+    EXPECT_DOUBLE_EQ(JaccardSimilarity(Flags {}, Flags {}), 1.0);
+}
+
+TEST(MinHash, EstimateSimilarity) {
+    const MinHasher<Feature> hasher {256};
+    EXPECT_EQ(hasher.HashCount(), 256);
+    for (const auto& [lhs, rhs] : {std::pair {Flags {0xFFFFU}, Flags {0xFFFFU}},
+                                   std::pair {Flags {0xFFFFU}, Flags {0xFFFF00U}},
+                                   std::pair {Flags {0xFFFFFFFFU}, Flags {0xFFFF0000FFFFU}}}) {
+        const auto estimate {MinHasher<Feature>::Similarity(hasher.Sign(lhs), hasher.Sign(rhs))};
+        EXPECT_NEAR(estimate, JaccardSimilarity(lhs, rhs), 0.1);
+    }
+
+    EXPECT_EQ(hasher.Sign(Flags {}), std::vector(256, MinHasher<Feature>::empty_value));
+}
+
+TEST(MinHash, BatchSignatures) {
+    const auto sets {MakeSets()};
+    const MinHasher<Feature> hasher {16, 42};
+    std::vector<MinHasher<Feature>::Value> signatures(sets.size() * hasher.HashCount());
+    hasher.Sign(sets, signatures, 4);
+    for (std::size_t i {0}; i != sets.size(); ++i) {
+        EXPECT_TRUE(std::ranges::equal(
+            std::span {signatures}.subspan(i * hasher.HashCount(), hasher.HashCount()),
+            hasher.Sign(sets[i])));
+    }
+}
+
+TEST(MinHash, LshIndex) {
+    auto sets {MakeSets()};
+    const Flags query {0xFFFF'FFFF'0000'0000U};
+    sets.push_back(query);
+    sets.emplace_back(0xFFFF'FFFF'0000'0001U);
+
+    MinHashLshIndex<Feature> index {32, 4};
+    EXPECT_EQ(index.Insert(sets), 0);
+    ASSERT_EQ(index.Size(), sets.size());
+
+    const auto candidates {index.Candidates(query)};
+    EXPECT_TRUE(std::ranges::binary_search(candidates, sets.size() - 2));
+    EXPECT_TRUE(std::ranges::binary_search(candidates, sets.size() - 1));
+    EXPECT_LT(candidates.size(), sets.size() / 2);
+
+    for (const auto i : index.Query(query, 0.9)) {
+        EXPECT_GE(JaccardSimilarity(index[i], query), 0.9);
+    }
+
+    EXPECT_EQ(index.Query(query, 0.9).size(), 2);
+    EXPECT_EQ(index.Insert(query), sets.size());
+}
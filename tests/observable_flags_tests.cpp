@@ -0,0 +1,135 @@
+#include "enum_flags/observable_flags.h"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+enum class Opt : std::uint8_t {
+    A = EnumFlags<Opt>::CreateFlag(0),
+    B = EnumFlags<Opt>::CreateFlag(1),
+    C = EnumFlags<Opt>::CreateFlag(2)
+};
+
+using Change = ObservableFlags<Opt>::Change;
+
+}  // namespace
+
+TEST(ObservableFlags, EdgeTriggered) {
+    ObservableFlags<Opt> flags {Opt::A};
+    std::vector<Change> rising, falling, both;
+    flags.Subscribe({Opt::A, Opt::B}, FlagEdge::Rising,
+                    [&rising](const Change& change) { rising.push_back(change); });
+    flags.Subscribe({Opt::A, Opt::B}, FlagEdge::Falling,
+                    [&falling](const Change& change) { falling.push_back(change); });
+    flags.Subscribe(Opt::C, {FlagEdge::Rising, FlagEdge::Falling},
+                    [&both](const Change& change) { both.push_back(change); });
+
+    // Unchanged flags notify nobody.
+    flags.Add(Opt::A);
+    EXPECT_TRUE(rising.empty() && falling.empty() && both.empty());
+
+    flags.Add({Opt::B, Opt::C});
+    ASSERT_EQ(rising.size(), 1);
+    EXPECT_EQ(rising.back().rising, Opt::B);
+    EXPECT_EQ(rising.back().falling, EnumFlags<Opt> {});
+    EXPECT_EQ(rising.back().flags, (EnumFlags<Opt> {Opt::A, Opt::B, Opt::C}));
+    EXPECT_TRUE(falling.empty());
+    ASSERT_EQ(both.size(), 1);
+    EXPECT_EQ(both.back().rising, Opt::C);
+
+    flags.Set({Opt::B, Opt::C});
+    EXPECT_EQ(rising.size(), 1);
+    ASSERT_EQ(falling.size(), 1);
+    EXPECT_EQ(falling.back().falling, Opt::A);
+    EXPECT_EQ(both.size(), 1);
+
+    flags.Remove(Opt::C);
+    ASSERT_EQ(both.size(), 2);
+    EXPECT_EQ(both.back().falling, Opt::C);
+}
+
+TEST(ObservableFlags, Unsubscribe) {
+    ObservableFlags<Opt> flags;
+    std::size_t first {0}, second {0};
+    const auto id {flags.Subscribe(Opt::A, FlagEdge::Rising, [&first](const Change&) { ++first; })};
+    std::size_t self {0};
+    self = flags.Subscribe(Opt::A, FlagEdge::Rising, [&](const Change&) {
+        ++second;
+        flags.Unsubscribe(self);
+    });
+
+    flags.Add(Opt::A);
+    EXPECT_EQ(first, 1);
+    EXPECT_EQ(second, 1);
+
+    flags.Unsubscribe(id);
+    flags.Remove(Opt::A);
+    flags.Add(Opt::A);
+    EXPECT_EQ(first, 1);
+    EXPECT_EQ(second, 1);
+
+    // Slots of removed subscribers are reused.
+    EXPECT_LT(flags.Subscribe(Opt::B, FlagEdge::Rising, [](const Change&) {}), 2);
+}
+
+TEST(ObservableFlags, UnsubscribeTwice) {
+    ObservableFlags<Opt> flags;
+    const auto id {flags.Subscribe(Opt::A, FlagEdge::Rising, [](const Change&) {})};
+    EXPECT_TRUE(flags.Unsubscribe(id));
+    EXPECT_FALSE(flags.Unsubscribe(id));
+    EXPECT_FALSE(flags.Unsubscribe(id + 1));
+
+    // A doubly removed ID is only reused once.
+    std::size_t first {0}, second {0};
+    const auto first_id {
+        flags.Subscribe(Opt::A, FlagEdge::Rising, [&first](const Change&) { ++first; })};
+    const auto second_id {
+        flags.Subscribe(Opt::A, FlagEdge::Rising, [&second](const Change&) { ++second; })};
+    EXPECT_NE(first_id, second_id);
+
+    flags.Add(Opt::A);
+    EXPECT_EQ(first, 1);
+    EXPECT_EQ(second, 1);
+}
+
+TEST(ObservableFlags, ManySubscribers) {
+    ObservableFlags<Opt> flags;
+    std::vector<std::size_t> counts(200);
+    for (std::size_t i {0}; i != counts.size(); ++i) {
+        const auto flag {i % 2 == 0 ? Opt::A : Opt::B};
+        flags.Subscribe(flag, FlagEdge::Rising, [&counts, i](const Change&) { ++counts[i]; });
+    }
+
+    flags.Add(Opt::B);
+    for (std::size_t i {0}; i != counts.size(); ++i) {
+        EXPECT_EQ(counts[i], i % 2 == 0 ? 0 : 1);
+    }
+}
+
+TEST(ObservableFlags, BatchedDispatch) {
+    ObservableFlags<Opt> flags {{}, true};
+    std::vector<Change> changes;
+    flags.Subscribe({Opt::A, Opt::B}, {FlagEdge::Rising, FlagEdge::Falling},
+                    [&changes](const Change& change) { changes.push_back(change); });
+    std::size_t c_count {0};
+    flags.Subscribe(Opt::C, FlagEdge::Rising, [&c_count](const Change&) { ++c_count; });
+
+    flags.Add(Opt::A);
+    flags.Add(Opt::B);
+    flags.Remove(Opt::A);
+    EXPECT_TRUE(changes.empty());
+
+    EXPECT_EQ(flags.Flush(), 1);
+    ASSERT_EQ(changes.size(), 1);
+    EXPECT_EQ(changes.back().rising, (EnumFlags<Opt> {Opt::A, Opt::B}));
+    EXPECT_EQ(changes.back().falling, Opt::A);
+    EXPECT_EQ(changes.back().flags, Opt::B);
+    EXPECT_EQ(c_count, 0);
+
+    EXPECT_EQ(flags.Flush(), 0);
+    EXPECT_EQ(changes.size(), 1);
+}
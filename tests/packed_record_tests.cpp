@@ -0,0 +1,87 @@
+#include "enum_flags/packed_record.h"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+enum class State : std::uint8_t {
+    Open = EnumFlags<State>::CreateFlag(0),
+    Dirty = EnumFlags<State>::CreateFlag(1),
+    Locked = EnumFlags<State>::CreateFlag(2)
+};
+
+enum class Access : unsigned int {
+    Read = EnumFlags<Access>::CreateFlag(0),
+    Write = EnumFlags<Access>::CreateFlag(1),
+    Exec = EnumFlags<Access>::CreateFlag(4)
+};
+
+using Record = PackedRecord<FlagsField<State>, FlagsField<Access>, UIntField<3>, UIntField<4>>;
+
+}  // namespace
+
+TEST(PackedRecord, Layout) {
+    static_assert(Record::bit_count == 3 + 5 + 3 + 4);
+    static_assert(std::same_as<Record::Word, std::uint16_t>);
+    static_assert(sizeof(Record) == sizeof(std::uint16_t));
+    static_assert(Record::offsets == std::array<std::size_t, 4> {0, 3, 8, 11});
+    static_assert(Record::mask<2> == 0b0000'0111'0000'0000);
+
+    using Wide = PackedRecord<UIntField<40>, FlagsField<Access>, UIntField<1>>;
+    static_assert(std::same_as<Wide::Word, std::uint64_t>);
+    static_assert(std::same_as<Wide::Value<0>, std::uint64_t>);
+    static_assert(std::same_as<Wide::Value<2>, std::uint32_t>);
+}
+
+TEST(PackedRecord, Fields) {
+    constexpr Record record {State::Open, {Access::Read, Access::Exec}, 5, 9};
+    static_assert(record.Get<0>() == State::Open);
+    static_assert(record.Get<1>() == EnumFlags<Access> {Access::Read, Access::Exec});
+    static_assert(record.Get<2>() == 5);
+    static_assert(record.Get<3>() == 9);
+    static_assert(record.Raw() == (0b001 | 0b10001 << 3 | 5 << 8 | 9 << 11));
+    static_assert(Record::FromRaw(record.Raw()) == record);
+
+    auto copy {record};
+    copy.Add<0>({State::Dirty, State::Locked}).Remove<1>(Access::Read).Set<2>(10);
+    EXPECT_TRUE(copy.Has<0>(State::Locked));
+    EXPECT_FALSE(copy.Has<1>(Access::Read));
+    EXPECT_TRUE(copy.Has<1>(Access::Exec));
+    EXPECT_EQ(copy.Get<0>(), (EnumFlags<State> {State::Open, State::Dirty, State::Locked}));
+    // Integers are truncated to the width of their fields.
+    EXPECT_EQ(copy.Get<2>(), 10 & 0b111);
+    EXPECT_EQ(copy.Get<3>(), 9);
+    EXPECT_NE(copy, record);
+
+    // Bits that are not valid flags are removed.
+    copy.Set<1>(0xFF);
+    EXPECT_EQ(copy.Get<1>(), (EnumFlags<Access> {Access::Read, Access::Write, Access::Exec}));
+    EXPECT_EQ(copy.Get<2>(), 10 & 0b111);
+}
+
+TEST(PackedRecord, Filter) {
+    constexpr auto filter {
+        Record::Filter {}.HasAll<0>(State::Open).HasNone<1>(Access::Write).Equal<3>(9)};
+    static_assert(filter.Matches(Record {State::Open, Access::Read, 0, 9}));
+    static_assert(!filter.Matches(Record {State::Open, Access::Write, 0, 9}));
+    static_assert(!filter.Matches(Record {State::Dirty, {}, 0, 9}));
+    static_assert(!filter.Matches(Record {State::Open, {}, 0, 8}));
+
+    std::vector<Record> records;
+    std::size_t expected {0};
+    for (std::uint16_t i {0}; i != 10'000; ++i) {
+        const auto record {Record::FromRaw(i)};
+        records.push_back(record);
+        expected += record.Has<0>(State::Open) && !record.Has<1>(Access::Write)
+                            && record.Get<3>() == 9
+                        ? 1
+                        : 0;
+    }
+
+    EXPECT_EQ(Record::Count(records, filter, 4), expected);
+    EXPECT_EQ(Record::Count(records, {}), records.size());
+}
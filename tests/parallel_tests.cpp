@@ -0,0 +1,24 @@
+#include "enum_flags/parallel.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <vector>
+
+TEST(Parallel, CoverAllRows) {
+    for (const std::size_t count : {0, 1, 10, 4096, 10000, 100001}) {
+        std::vector<std::atomic_int> visits(count);
+        ParallelFor(
+            count,
+            [&visits](const std::size_t begin, const std::size_t end) {
+                for (auto i {begin}; i != end; ++i) {
+                    ++visits[i];
+                }
+            },
+            4, 1000);
+
+        for (const auto& visit : visits) {
+            EXPECT_EQ(visit, 1);
+        }
+    }
+}
@@ -0,0 +1,65 @@
+#include "enum_flags/replicated_flags.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+
+enum class Opt : unsigned int {
+    A = EnumFlags<Opt>::CreateFlag(0),
+    B = EnumFlags<Opt>::CreateFlag(1),
+    C = EnumFlags<Opt>::CreateFlag(2)
+};
+
+}  // namespace
+
+TEST(ReplicatedFlags, ReadAndWrite) {
+    ReplicatedFlags<Opt> flags {Opt::A, 4};
+    EXPECT_TRUE(flags.Has(Opt::A));
+    EXPECT_EQ(flags.LoadVersioned().generation, 0);
+
+    flags.Add({Opt::B, Opt::C});
+    EXPECT_TRUE(flags.HasAll({Opt::A, Opt::B, Opt::C}));
+
+    flags.Remove(Opt::A);
+    EXPECT_FALSE(flags.Has(Opt::A));
+
+    flags.Set(Opt::C);
+    EXPECT_EQ(flags.Load(), Opt::C);
+    EXPECT_EQ(flags.LoadVersioned().generation, 3);
+}
+
+TEST(ReplicatedFlags, ReplicasAgreeAcrossThreads) {
+    ReplicatedFlags<Opt> flags {{}, 3};
+    std::atomic_bool done {false};
+    std::vector<std::thread> readers;
+    for (std::size_t i {0}; i != 4; ++i) {
+        readers.emplace_back([&flags, &done] {
+            const EnumFlags<Opt> all {Opt::A, Opt::B, Opt::C};
+            std::uint64_t last {0};
+            while (!done) {
+                // Writes alternate between {A} and {A, B, C}, so no other value can be observed.
+                const auto [value, generation] {flags.LoadVersioned()};
+                EXPECT_GE(generation, last);
+                last = generation;
+                if (generation != 0) {
+                    EXPECT_TRUE(value == Opt::A || value == all);
+                }
+            }
+
+            EXPECT_TRUE(flags.HasAll(all));
+        });
+    }
+
+    for (std::size_t i {0}; i != 1000; ++i) {
+        flags.Set(i % 2 == 0 ? EnumFlags<Opt> {Opt::A} : EnumFlags<Opt> {Opt::A, Opt::B, Opt::C});
+    }
+
+    done = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+}
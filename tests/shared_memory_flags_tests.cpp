@@ -0,0 +1,205 @@
+#include "enum_flags/shared_memory_flags.h"
+
+#include <gtest/gtest.h>
+
+#if defined(__linux__)
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+
+namespace {
+
+enum class Opt : std::uint32_t {
+    A = EnumFlags<Opt>::CreateFlag(0),
+    B = EnumFlags<Opt>::CreateFlag(1),
+    C = EnumFlags<Opt>::CreateFlag(2)
+};
+
+enum class OtherOpt : std::uint32_t {
+    A = EnumFlags<OtherOpt>::CreateFlag(0)
+};
+
+//! An unrelated enumeration with the same width and valid flags as @p Opt.
+enum class Status : std::uint32_t {
+    X = EnumFlags<Status>::CreateFlag(0),
+    Y = EnumFlags<Status>::CreateFlag(1),
+    Z = EnumFlags<Status>::CreateFlag(2)
+};
+
+//! Another declaration of @p Opt, such as one in another program.
+enum class MirroredOpt : std::uint32_t {
+    X = EnumFlags<MirroredOpt>::CreateFlag(0),
+    Y = EnumFlags<MirroredOpt>::CreateFlag(1),
+    Z = EnumFlags<MirroredOpt>::CreateFlag(2)
+};
+
+enum class WideOpt : std::uint64_t {
+    A = EnumFlags<WideOpt>::CreateFlag(0)
+};
+
+}  // namespace
+
+template <>
+struct EnumFlagsTraits<Opt> {
+    static constexpr std::string_view name {"opt"};
+};
+
+template <>
+struct EnumFlagsTraits<OtherOpt> {
+    static constexpr std::string_view name {"other_opt"};
+};
+
+template <>
+struct EnumFlagsTraits<Status> {
+    static constexpr std::string_view name {"status"};
+};
+
+template <>
+struct EnumFlagsTraits<MirroredOpt> {
+    static constexpr std::string_view name {"opt"};
+};
+
+template <>
+struct EnumFlagsTraits<WideOpt> {
+    static constexpr std::string_view name {"wide_opt"};
+};
+
+namespace {
+
+std::string SegmentName(const std::string& test) {
+    return "/enum_flags_" + test + "_" + std::to_string(getpid());
+}
+
+}  // namespace
+
+TEST(SharedFlagsSegment, CreateAndOpen) {
+    const auto name {SegmentName("create")};
+    auto created {SharedFlagsSegment<Opt>::Create(name, 4)};
+    ASSERT_TRUE(created);
+    EXPECT_EQ(created->Size(), 4);
+    EXPECT_EQ(created->Load(0), EnumFlags<Opt> {});
+
+    // A second mapping observes updates through the first one.
+    auto opened {SharedFlagsSegment<Opt>::Open(name)};
+    ASSERT_TRUE(opened);
+    EXPECT_EQ(opened->Size(), 4);
+    EXPECT_EQ(created->Add(1, {Opt::A, Opt::B}), EnumFlags<Opt> {});
+    EXPECT_TRUE(opened->HasAll(1, {Opt::A, Opt::B}));
+    EXPECT_FALSE(opened->Has(0, Opt::A));
+
+    EXPECT_EQ(opened->Remove(1, Opt::A), (EnumFlags<Opt> {Opt::A, Opt::B}));
+    EXPECT_EQ(created->Load(1), Opt::B);
+
+    opened->Store(3, Opt::C);
+    EXPECT_TRUE(created->HasAny(3, {Opt::A, Opt::C}));
+
+    // Creating an existing segment fails.
+    const auto again {SharedFlagsSegment<Opt>::Create(name, 4)};
+    ASSERT_FALSE(again);
+    EXPECT_EQ(again.error(), std::errc::file_exists);
+
+    EXPECT_FALSE(SharedFlagsSegment<Opt>::Unlink(name));
+    EXPECT_EQ(SharedFlagsSegment<Opt>::Open(name).error(), std::errc::no_such_file_or_directory);
+
+    // The mappings stay valid after the name is removed.
+    EXPECT_EQ(opened->Load(1), Opt::B);
+}
+
+TEST(SharedFlagsSegment, OpenValidatesHeader) {
+    const auto name {SegmentName("validate")};
+    const auto created {SharedFlagsSegment<Opt>::Create(name, 1)};
+    ASSERT_TRUE(created);
+    EXPECT_EQ(SharedFlagsSegment<OtherOpt>::Open(name).error(), std::errc::invalid_argument);
+    EXPECT_EQ(SharedFlagsSegment<WideOpt>::Open(name).error(), std::errc::invalid_argument);
+    EXPECT_EQ(SharedFlagsSegment<Status>::Open(name).error(), std::errc::invalid_argument);
+    EXPECT_TRUE(SharedFlagsSegment<Opt>::Open(name));
+    EXPECT_TRUE(SharedFlagsSegment<MirroredOpt>::Open(name));
+    SharedFlagsSegment<Opt>::Unlink(name);
+}
+
+TEST(SharedFlagsSegment, OpenBeforeReady) {
+    const auto name {SegmentName("ready")};
+    const auto fd {shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600)};
+    ASSERT_NE(fd, -1);
+
+    // A segment that has not been resized yet.
+    EXPECT_EQ(SharedFlagsSegment<Opt>::Open(name).error(),
+              std::errc::resource_unavailable_try_again);
+
+    // A segment whose header has not been written yet.
+    ASSERT_EQ(ftruncate(fd, 4096), 0);
+    EXPECT_EQ(SharedFlagsSegment<Opt>::Open(name).error(),
+              std::errc::resource_unavailable_try_again);
+
+    close(fd);
+    SharedFlagsSegment<Opt>::Unlink(name);
+}
+
+TEST(SharedFlagsSegment, WaitBetweenThreads) {
+    const auto name {SegmentName("threads")};
+    auto waiter {SharedFlagsSegment<Opt>::Create(name, 2)};
+    auto setter {SharedFlagsSegment<Opt>::Open(name)};
+    ASSERT_TRUE(waiter && setter);
+    SharedFlagsSegment<Opt>::Unlink(name);
+
+    std::jthread thread {[&setter] {
+        setter->Add(1, Opt::A);
+        std::this_thread::sleep_for(std::chrono::milliseconds {10});
+        setter->Add(1, Opt::B);
+    }};
+
+    EXPECT_TRUE(waiter->WaitAny(1, {Opt::A, Opt::C}).Has(Opt::A));
+    EXPECT_TRUE(waiter->WaitAll(1, {Opt::A, Opt::B}).HasAll({Opt::A, Opt::B}));
+}
+
+TEST(SharedFlagsSegment, WaitTimeout) {
+    const auto name {SegmentName("timeout")};
+    auto segment {SharedFlagsSegment<Opt>::Create(name, 1)};
+    ASSERT_TRUE(segment);
+    SharedFlagsSegment<Opt>::Unlink(name);
+
+    segment->Add(0, Opt::A);
+    EXPECT_FALSE(segment->WaitAll(0, {Opt::A, Opt::B}, std::chrono::milliseconds {10}));
+    EXPECT_EQ(segment->WaitAny(0, {Opt::A, Opt::B}, std::chrono::milliseconds {10}), Opt::A);
+}
+
+TEST(SharedFlagsSegment, WaitBetweenProcesses) {
+    const auto name {SegmentName("processes")};
+    auto supervisor {SharedFlagsSegment<Opt>::Create(name, 1)};
+    ASSERT_TRUE(supervisor);
+
+    const auto pid {fork()};
+    ASSERT_NE(pid, -1);
+    if (pid == 0) {
+        auto worker {SharedFlagsSegment<Opt>::Open(name)};
+        if (!worker) {
+            _exit(1);
+        }
+
+        worker->Add(0, Opt::A);
+        worker->WaitAll(0, Opt::B);
+        worker->Add(0, Opt::C);
+        _exit(0);
+    }
+
+    EXPECT_TRUE(supervisor->WaitAll(0, Opt::A).Has(Opt::A));
+    supervisor->Add(0, Opt::B);
+    EXPECT_TRUE(supervisor->WaitAll(0, Opt::C).HasAll({Opt::A, Opt::B, Opt::C}));
+
+    int status {0};
+    ASSERT_EQ(waitpid(pid, &status, 0), pid);
+    EXPECT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(WEXITSTATUS(status), 0);
+    SharedFlagsSegment<Opt>::Unlink(name);
+}
+
+#endif
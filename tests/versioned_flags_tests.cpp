@@ -0,0 +1,87 @@
+#include "enum_flags/versioned_flags.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace {
+
+enum class Opt : std::uint32_t {
+    A = EnumFlags<Opt>::CreateFlag(0),
+    B = EnumFlags<Opt>::CreateFlag(1),
+    C = EnumFlags<Opt>::CreateFlag(2)
+};
+
+enum class WideOpt : std::uint64_t {
+    A = EnumFlags<WideOpt>::CreateFlag(0),
+    Z = EnumFlags<WideOpt>::CreateFlag(63)
+};
+
+}  // namespace
+
+TEST(VersionedEnumFlags, PackedWidth) {
+    EXPECT_EQ(VersionedEnumFlags<Opt>::version_bits, 32);
+    EXPECT_EQ(VersionedEnumFlags<WideOpt>::version_bits, 64);
+}
+
+TEST(VersionedEnumFlags, CompareExchangeDetectsAba) {
+    VersionedEnumFlags<Opt> flags {Opt::A};
+    auto seen {flags.Load()};
+    EXPECT_EQ(seen.flags, Opt::A);
+    EXPECT_EQ(seen.version, 0);
+
+    // A -> B -> A by another thread.
+    flags.Add(Opt::B);
+    flags.Remove(Opt::B);
+    EXPECT_EQ(flags.Load().flags, Opt::A);
+    EXPECT_EQ(flags.Load().version, 2);
+
+    EXPECT_FALSE(flags.CompareExchange(seen, Opt::C));
+    EXPECT_EQ(seen.flags, Opt::A);
+    EXPECT_EQ(seen.version, 2);
+
+    EXPECT_TRUE(flags.CompareExchange(seen, Opt::C));
+    EXPECT_EQ(seen.flags, Opt::C);
+    EXPECT_EQ(seen.version, 3);
+    EXPECT_EQ(flags.Load(), seen);
+}
+
+TEST(VersionedEnumFlags, WideFlags) {
+    VersionedEnumFlags<WideOpt> flags;
+    const auto result {flags.Add({WideOpt::A, WideOpt::Z})};
+    EXPECT_TRUE(result.flags.HasAll({WideOpt::A, WideOpt::Z}));
+    EXPECT_EQ(result.version, 1);
+
+    auto stale {flags.Load()};
+    flags.Remove(WideOpt::Z);
+    flags.Add(WideOpt::Z);
+    EXPECT_FALSE(flags.CompareExchange(stale, {}));
+    EXPECT_EQ(stale.version, 3);
+}
+
+TEST(VersionedEnumFlags, ConcurrentUpdates) {
+    constexpr std::size_t thread_count {4};
+    constexpr std::size_t iterations {1000};
+
+    VersionedEnumFlags<Opt> flags;
+    std::vector<std::thread> threads;
+    for (std::size_t t {0}; t != thread_count; ++t) {
+        threads.emplace_back([&flags] {
+            for (std::size_t i {0}; i != iterations; ++i) {
+                flags.Update([](const EnumFlags<Opt> old) noexcept {
+                    return old.Has(Opt::A) ? EnumFlags<Opt> {Opt::B} : EnumFlags<Opt> {Opt::A};
+                });
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    const auto result {flags.Load()};
+    EXPECT_EQ(result.version, thread_count * iterations);
+    EXPECT_EQ(result.flags, Opt::B);
+}
@@ -0,0 +1,99 @@
+#include "enum_flags/windowed_flag_counter.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+
+namespace {
+
+enum class Opt : unsigned int {
+    A = EnumFlags<Opt>::CreateFlag(0),
+    B = EnumFlags<Opt>::CreateFlag(1),
+    C = EnumFlags<Opt>::CreateFlag(2)
+};
+
+using Clock = std::chrono::steady_clock;
+
+Clock::time_point At(const std::chrono::seconds time) {
+    return Clock::time_point {time};
+}
+
+}  // namespace
+
+TEST(WindowedFlagCounter, CountBasedWindow) {
+    WindowedFlagCounter<Opt> counter {std::size_t {3}, 3};
+    counter.Insert(Opt::A);
+    counter.Insert({Opt::A, Opt::B});
+    counter.Insert(Opt::B);
+    EXPECT_EQ(counter.Events(), 3);
+    EXPECT_EQ(counter.Count(Opt::A), 2);
+    EXPECT_EQ(counter.Count(Opt::B), 2);
+    EXPECT_EQ(counter.Count(Opt::C), 0);
+
+    counter.Insert(Opt::C);
+    EXPECT_EQ(counter.Events(), 3);
+    EXPECT_EQ(counter.Count(Opt::A), 1);
+    EXPECT_EQ(counter.Count(Opt::B), 2);
+    EXPECT_EQ(counter.Count(Opt::C), 1);
+
+    counter.Insert({});
+    counter.Insert({});
+    EXPECT_EQ(counter.Events(), 3);
+    EXPECT_EQ(counter.Count(Opt::A), 0);
+    EXPECT_EQ(counter.Count(Opt::B), 0);
+    EXPECT_EQ(counter.Count(Opt::C), 1);
+}
+
+TEST(WindowedFlagCounter, TimeBasedWindow) {
+    using namespace std::chrono_literals;
+    WindowedFlagCounter<Opt> counter {60s, 6};
+    counter.Insert({Opt::A, Opt::B}, At(100s));
+    counter.Insert(Opt::A, At(125s));
+    counter.Insert(Opt::C, At(155s));
+    EXPECT_EQ(counter.Events(), 3);
+    EXPECT_EQ(counter.Count(Opt::A), 2);
+
+    // An event older than the window is ignored.
+    counter.Insert(Opt::C, At(80s));
+    EXPECT_EQ(counter.Count(Opt::C), 1);
+
+    // A late event inside the window is counted.
+    counter.Insert(Opt::C, At(120s));
+    EXPECT_EQ(counter.Count(Opt::C), 2);
+
+    counter.Advance(At(165s));
+    EXPECT_EQ(counter.Events(), 3);
+    EXPECT_EQ(counter.Count(Opt::A), 1);
+    EXPECT_EQ(counter.Count(Opt::B), 0);
+
+    const auto snapshot {counter.Read()};
+    EXPECT_EQ(snapshot.Events(), 3);
+    EXPECT_DOUBLE_EQ(snapshot.Ratio(Opt::C), 2.0 / 3.0);
+
+    counter.Advance(At(1000s));
+    EXPECT_EQ(counter.Events(), 0);
+    EXPECT_EQ(counter.Count(Opt::C), 0);
+    EXPECT_EQ(counter.Read().Ratio(Opt::C), 0.0);
+}
+
+TEST(WindowedFlagCounter, ConcurrentSnapshots) {
+    WindowedFlagCounter<Opt> counter {std::size_t {100}, 10};
+    std::atomic_bool done {false};
+    std::thread writer {[&counter, &done] {
+        for (std::size_t i {0}; i != 100000; ++i) {
+            counter.Insert({Opt::A, Opt::B});
+        }
+
+        done = true;
+    }};
+
+    while (!done) {
+        const auto snapshot {counter.Read()};
+        EXPECT_EQ(snapshot.Count(Opt::A), snapshot.Events());
+        EXPECT_EQ(snapshot.Count(Opt::B), snapshot.Events());
+        EXPECT_EQ(snapshot.Count(Opt::C), 0);
+    }
+
+    writer.join();
+}